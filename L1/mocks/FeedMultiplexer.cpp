@@ -0,0 +1,515 @@
+// io_uring multi-channel feed multiplexer.
+// Compile: g++ -std=c++17 -O2 FeedMultiplexer.cpp -o FeedMultiplexer -pthread
+//
+// MarketFeed.cpp drains one blocking socket; production listens to 8+
+// multicast channels (A/B arbitrated pairs) plus recovery, and a thread per
+// socket wastes cores. This multiplexer runs every channel on one pinned
+// core through a single io_uring: each socket gets a multishot receive armed
+// once, datagrams land in receive buffers registered with the ring up front
+// (IORING_OP_PROVIDE_BUFFERS; the newer PBUF_RING registration is not
+// functional on every kernel we deploy on, and the provide op costs nothing
+// at steady state because recycles are batched), and completions for all
+// channels are reaped from the shared memory-mapped CQ ring. Steady state
+// needs no per-datagram syscall — the loop reads CQEs from shared memory and
+// amortizes one io_uring_enter over a whole batch of buffer recycles;
+// io_uring_enter otherwise runs only when the CQ is dry (to block) or a
+// multishot arm terminates (to re-arm). Per-line sequence tracking detects
+// gaps; A/B arbitration takes whichever leg delivers a packet first and
+// drops the twin, so a drop on one leg costs nothing if the other leg saw
+// it. Framed records are delivered into one Fifo3 per line, same as the
+// single-channel feed.
+//
+// Raw syscalls throughout — no liburing dependency.
+
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <linux/io_uring.h>
+
+#include "../../SPSC_QUEUES/spsc_q3.cpp"
+
+// Same 24-byte record the single-channel feed frames (MarketFeed.cpp); the
+// wire bytes are the struct
+struct MarketData {
+    uint64_t timestamp;
+    double price;
+    uint32_t volume;
+};
+static_assert(sizeof(MarketData) == 24, "MarketData layout changed");
+
+// Channelized framing: every datagram carries its channel's packet sequence
+// so the receiver can detect gaps and arbitrate A/B twins
+struct FeedPacketHeader {
+    uint32_t seq;        // per-line packet sequence, starts at 0
+    uint16_t line;       // logical line id (shared by the A and B legs)
+    uint16_t count;      // MarketData records following the header
+};
+static_assert(sizeof(FeedPacketHeader) == 8, "packet header layout changed");
+
+// ---------------- raw io_uring plumbing ----------------
+
+static int sys_io_uring_setup(unsigned entries, io_uring_params* p) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, p));
+}
+static int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete,
+                              unsigned flags) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit,
+                                      min_complete, flags, nullptr, 0));
+}
+static int sys_io_uring_register(int fd, unsigned opcode, void* arg, unsigned nr) {
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nr));
+}
+
+// Minimal single-threaded io_uring wrapper: SQ/CQ mapped once, SQEs filled
+// in place, CQEs consumed straight off the shared ring
+class IoUring {
+public:
+    explicit IoUring(unsigned entries) {
+        io_uring_params p{};
+        ring_fd_ = sys_io_uring_setup(entries, &p);
+        if (ring_fd_ < 0) {
+            perror("io_uring_setup");
+            std::exit(1);
+        }
+
+        size_t sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        size_t cq_size = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        sq_ring_ = static_cast<char*>(::mmap(nullptr, sq_size, PROT_READ | PROT_WRITE,
+                                             MAP_SHARED | MAP_POPULATE, ring_fd_,
+                                             IORING_OFF_SQ_RING));
+        cq_ring_ = static_cast<char*>(::mmap(nullptr, cq_size, PROT_READ | PROT_WRITE,
+                                             MAP_SHARED | MAP_POPULATE, ring_fd_,
+                                             IORING_OFF_CQ_RING));
+        sqes_ = static_cast<io_uring_sqe*>(
+            ::mmap(nullptr, p.sq_entries * sizeof(io_uring_sqe),
+                   PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                   IORING_OFF_SQES));
+        if (sq_ring_ == MAP_FAILED || cq_ring_ == MAP_FAILED ||
+            sqes_ == MAP_FAILED) {
+            perror("mmap rings");
+            std::exit(1);
+        }
+
+        sq_head_ = reinterpret_cast<std::atomic<unsigned>*>(sq_ring_ + p.sq_off.head);
+        sq_tail_ = reinterpret_cast<std::atomic<unsigned>*>(sq_ring_ + p.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned*>(sq_ring_ + p.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq_ring_ + p.sq_off.array);
+        cq_head_ = reinterpret_cast<std::atomic<unsigned>*>(cq_ring_ + p.cq_off.head);
+        cq_tail_ = reinterpret_cast<std::atomic<unsigned>*>(cq_ring_ + p.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned*>(cq_ring_ + p.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq_ring_ + p.cq_off.cqes);
+    }
+
+    ~IoUring() {
+        if (ring_fd_ >= 0) ::close(ring_fd_);
+    }
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    [[nodiscard]] int fd() const { return ring_fd_; }
+
+    // Next free SQE, zeroed. Queue as many as needed, then one
+    // submit_pending() hands them all to the kernel in a single enter.
+    io_uring_sqe* get_sqe() {
+        unsigned tail = sq_tail_->load(std::memory_order_relaxed) + queued_;
+        io_uring_sqe* sqe = &sqes_[tail & sq_mask_];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sq_array_[tail & sq_mask_] = tail & sq_mask_;
+        ++queued_;
+        return sqe;
+    }
+
+    void submit_pending() {
+        if (queued_ == 0) {
+            return;
+        }
+        sq_tail_->store(sq_tail_->load(std::memory_order_relaxed) + queued_,
+                        std::memory_order_release);
+        if (sys_io_uring_enter(ring_fd_, queued_, 0, 0) < 0) {
+            perror("io_uring_enter(submit)");
+        }
+        queued_ = 0;
+    }
+
+    // Reap one CQE if available; no syscall. Caller must seen() it after.
+    io_uring_cqe* peek_cqe() {
+        unsigned head = cq_head_->load(std::memory_order_relaxed);
+        if (head == cq_tail_->load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &cqes_[head & cq_mask_];
+    }
+
+    void seen() {
+        cq_head_->fetch_add(1, std::memory_order_release);
+    }
+
+    // Block until at least one completion arrives
+    void wait() {
+        sys_io_uring_enter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS);
+    }
+
+private:
+    int ring_fd_ = -1;
+    char* sq_ring_ = nullptr;
+    char* cq_ring_ = nullptr;
+    io_uring_sqe* sqes_ = nullptr;
+    std::atomic<unsigned>* sq_head_ = nullptr;
+    std::atomic<unsigned>* sq_tail_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned sq_mask_ = 0;
+    std::atomic<unsigned>* cq_head_ = nullptr;
+    std::atomic<unsigned>* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    unsigned queued_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+};
+
+// ---------------- multiplexer ----------------
+
+class FeedMultiplexer {
+public:
+    static constexpr size_t MAX_DATAGRAM = 2048;     // power-of-two slot size
+    static constexpr unsigned BUF_COUNT = 256;       // provided-buffer ring slots
+    static constexpr uint16_t BUF_GROUP = 0;
+
+    struct ChannelStats {
+        uint64_t packets = 0;
+        uint64_t duplicates = 0;   // twin already delivered by the other leg
+        uint64_t gaps = 0;         // sequences neither leg had delivered in time
+                                   // (recovery session's job from here)
+    };
+
+    // channels: one UDP port per leg; legs 2k and 2k+1 arbitrate line k
+    FeedMultiplexer(const std::vector<uint16_t>& ports, size_t fifo_capacity)
+        : ring_(256), channels_(ports.size()) {
+        for (size_t i = 0; i < ports.size(); ++i) {
+            channels_[i].fd = open_channel(ports[i]);
+        }
+        lines_.resize((ports.size() + 1) / 2);
+        for (auto& line : lines_) {
+            line.out = std::make_unique<Fifo3<MarketData>>(fifo_capacity);
+        }
+        setup_buffer_ring();
+        for (size_t i = 0; i < channels_.size(); ++i) {
+            arm_recv(i);
+        }
+        ring_.submit_pending();
+    }
+
+    ~FeedMultiplexer() {
+        for (auto& ch : channels_) ::close(ch.fd);
+        if (buffers_) {
+            ::munmap(buffers_, BUF_COUNT * MAX_DATAGRAM);
+        }
+    }
+
+    // Reap every available completion without a syscall; blocks only when
+    // the CQ is empty and `block` is set. Returns datagrams processed.
+    // Consumed buffers and any re-arms are queued and handed back with one
+    // io_uring_enter per batch, so the per-datagram cost is CQ-ring reads.
+    size_t poll(bool block = true) {
+        size_t processed = 0;
+        bool rearm_needed = false;
+        for (;;) {
+            io_uring_cqe* cqe = ring_.peek_cqe();
+            if (!cqe) {
+                flush_recycles();
+                if (processed == 0 && block) {
+                    ring_.wait();
+                    continue;
+                }
+                return processed;
+            }
+
+            uint64_t ud = cqe->user_data;
+            int res = cqe->res;
+            unsigned flags = cqe->flags;
+            ring_.seen();
+
+            if (ud == RECYCLE_UD) {
+                continue;   // completion of a provide-buffers op
+            }
+            size_t channel = static_cast<size_t>(ud);
+            if (res > 0 && (flags & IORING_CQE_F_BUFFER)) {
+                uint16_t bid = static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+                on_datagram(channel, buffer_at(bid), static_cast<size_t>(res));
+                consumed_[consumed_count_++] = bid;
+                if (consumed_count_ == RECYCLE_BATCH) {
+                    flush_recycles();
+                }
+                ++processed;
+            }
+            // Multishot arm terminated (buffer exhaustion, error): re-arm
+            // after the buffers it was starved of go back to the kernel
+            if (!(flags & IORING_CQE_F_MORE)) {
+                rearm_needed = true;
+                rearm_channel_ = channel;
+            }
+            if (rearm_needed) {
+                flush_recycles();
+                arm_recv(rearm_channel_);
+                ring_.submit_pending();
+                rearm_needed = false;
+            }
+        }
+    }
+
+    [[nodiscard]] Fifo3<MarketData>& line_output(size_t line) {
+        return *lines_[line].out;
+    }
+    [[nodiscard]] const ChannelStats& line_stats(size_t line) const {
+        return lines_[line].stats;
+    }
+
+private:
+    struct Channel {
+        int fd = -1;
+    };
+
+    // Arbitration state per A/B line: first leg to deliver a sequence wins
+    struct Line {
+        uint32_t next_seq = 0;
+        ChannelStats stats;
+        std::unique_ptr<Fifo3<MarketData>> out;
+    };
+
+    static int open_channel(uint16_t port) {
+        int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+        int reuse = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        int rcvbuf = 4 * 1024 * 1024;
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons(port);
+        if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            perror("bind");
+            std::exit(1);
+        }
+        // Production joins the channel's multicast group here, exactly as
+        // BatchedMarketFeed does; the demo publishes to loopback instead
+        return fd;
+    }
+
+    // Register the receive buffers with the ring once: the kernel picks a
+    // free slot per datagram and reports the buffer id in the CQE flags
+    void setup_buffer_ring() {
+        buffers_ = static_cast<char*>(::mmap(nullptr, BUF_COUNT * MAX_DATAGRAM,
+                                             PROT_READ | PROT_WRITE,
+                                             MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE,
+                                             -1, 0));
+        if (buffers_ == MAP_FAILED) {
+            perror("mmap buffers");
+            std::exit(1);
+        }
+
+        // One op provides the whole contiguous range (bids 0..BUF_COUNT-1)
+        io_uring_sqe* sqe = ring_.get_sqe();
+        sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+        sqe->fd = BUF_COUNT;                               // nbufs
+        sqe->addr = reinterpret_cast<uint64_t>(buffers_);
+        sqe->len = MAX_DATAGRAM;
+        sqe->buf_group = BUF_GROUP;
+        sqe->off = 0;                                      // starting bid
+        sqe->user_data = RECYCLE_UD;
+        ring_.submit_pending();
+    }
+
+    [[nodiscard]] char* buffer_at(uint16_t bid) const {
+        return buffers_ + static_cast<size_t>(bid) * MAX_DATAGRAM;
+    }
+
+    // Hand a batch of consumed buffers back to the kernel with one enter
+    void flush_recycles() {
+        if (consumed_count_ == 0) {
+            return;
+        }
+        for (size_t i = 0; i < consumed_count_; ++i) {
+            io_uring_sqe* sqe = ring_.get_sqe();
+            sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+            sqe->fd = 1;
+            sqe->addr = reinterpret_cast<uint64_t>(buffer_at(consumed_[i]));
+            sqe->len = MAX_DATAGRAM;
+            sqe->buf_group = BUF_GROUP;
+            sqe->off = consumed_[i];
+            sqe->user_data = RECYCLE_UD;
+        }
+        consumed_count_ = 0;
+        ring_.submit_pending();
+    }
+
+    // One multishot receive per channel: armed once, completes per datagram
+    // until the kernel cancels it. Queues only; caller submits.
+    void arm_recv(size_t channel) {
+        io_uring_sqe* sqe = ring_.get_sqe();
+        sqe->opcode = IORING_OP_RECV;
+        sqe->fd = channels_[channel].fd;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = BUF_GROUP;
+        sqe->user_data = channel;
+    }
+
+    void on_datagram(size_t channel, const char* bytes, size_t len) {
+        if (len < sizeof(FeedPacketHeader)) {
+            return;
+        }
+        FeedPacketHeader hdr;
+        std::memcpy(&hdr, bytes, sizeof(hdr));
+        size_t line_idx = channel / 2;   // legs 2k/2k+1 carry line k
+        if (hdr.line != line_idx || line_idx >= lines_.size()) {
+            return;
+        }
+        Line& line = lines_[line_idx];
+
+        // A/B arbitration on the line sequence: the first leg to deliver a
+        // packet wins, its twin is a duplicate, and anything still missing
+        // when a later sequence arrives was lost on both legs
+        if (hdr.seq < line.next_seq) {
+            ++line.stats.duplicates;
+            return;
+        }
+        if (hdr.seq > line.next_seq) {
+            line.stats.gaps += hdr.seq - line.next_seq;
+        }
+        line.next_seq = hdr.seq + 1;
+        ++line.stats.packets;
+
+        const auto* records =
+            reinterpret_cast<const MarketData*>(bytes + sizeof(FeedPacketHeader));
+        for (uint16_t i = 0; i < hdr.count; ++i) {
+            MarketData md;
+            std::memcpy(&md, &records[i], sizeof(md));
+            while (!line.out->push(md)) { /* consumer behind */ }
+        }
+    }
+
+    static constexpr uint64_t RECYCLE_UD = ~uint64_t{0};
+    static constexpr size_t RECYCLE_BATCH = 64;
+
+    IoUring ring_;
+    std::vector<Channel> channels_;
+    std::vector<Line> lines_;
+    char* buffers_ = nullptr;
+    uint16_t consumed_[RECYCLE_BATCH];
+    size_t consumed_count_ = 0;
+    size_t rearm_channel_ = 0;
+};
+
+// ---------------- demo ----------------
+
+// Publishes one line's flow over both legs with independent simulated loss,
+// so arbitration has real work: a packet dropped on one leg must still be
+// delivered (once) via the other.
+int main() {
+    const uint16_t BASE_PORT = 31001;
+    const size_t LINES = 2;                    // 4 channels: A/B per line
+    const size_t PACKETS_PER_LINE = 2000;
+    const size_t RECORDS_PER_PACKET = 40;
+
+    std::vector<uint16_t> ports;
+    for (size_t i = 0; i < LINES * 2; ++i) {
+        ports.push_back(static_cast<uint16_t>(BASE_PORT + i));
+    }
+    FeedMultiplexer mux(ports, 1 << 17);
+
+    std::thread publisher([&] {
+        int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+        std::mt19937 gen(5);
+        std::uniform_int_distribution<> loss(0, 99);
+        char packet[sizeof(FeedPacketHeader) + RECORDS_PER_PACKET * sizeof(MarketData)];
+
+        for (size_t p = 0; p < PACKETS_PER_LINE; ++p) {
+            for (size_t line = 0; line < LINES; ++line) {
+                auto* hdr = reinterpret_cast<FeedPacketHeader*>(packet);
+                hdr->seq = static_cast<uint32_t>(p);
+                hdr->line = static_cast<uint16_t>(line);
+                hdr->count = RECORDS_PER_PACKET;
+                auto* recs = reinterpret_cast<MarketData*>(packet + sizeof(*hdr));
+                for (size_t r = 0; r < RECORDS_PER_PACKET; ++r) {
+                    uint64_t seq = p * RECORDS_PER_PACKET + r;
+                    recs[r] = {seq, 100.0 + (seq % 200) * 0.01,
+                               static_cast<uint32_t>(1 + seq % 500)};
+                }
+                // 10% independent loss per leg: both legs dropping the same
+                // packet (a real gap) is ~1%
+                for (size_t leg = 0; leg < 2; ++leg) {
+                    if (loss(gen) < 10) continue;
+                    sockaddr_in dest{};
+                    dest.sin_family = AF_INET;
+                    dest.sin_addr.s_addr = inet_addr("127.0.0.1");
+                    dest.sin_port = htons(static_cast<uint16_t>(BASE_PORT + line * 2 + leg));
+                    ::sendto(fd, packet, sizeof(packet), 0,
+                             reinterpret_cast<sockaddr*>(&dest), sizeof(dest));
+                }
+            }
+            if (p % 50 == 0) {
+                // Yield so a single-core box lets the receiver drain
+                std::this_thread::sleep_for(std::chrono::microseconds(500));
+            }
+        }
+        ::close(fd);
+    });
+
+    // Single receive loop across all channels (production pins this core)
+    size_t datagrams = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    auto deadline = start + std::chrono::seconds(20);
+    size_t delivered_target = 0;   // packets - both-leg losses, known only after
+    while (std::chrono::high_resolution_clock::now() < deadline) {
+        datagrams += mux.poll(false);
+        bool all_done = true;
+        for (size_t l = 0; l < LINES; ++l) {
+            if (mux.line_stats(l).packets + mux.line_stats(l).gaps < PACKETS_PER_LINE) {
+                all_done = false;
+            }
+        }
+        if (all_done && datagrams > 0) break;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    publisher.join();
+    (void)delivered_target;
+
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    std::cout << "mux: " << datagrams << " datagrams across " << LINES * 2
+              << " channels in " << micros << " us\n";
+
+    bool ok = true;
+    for (size_t l = 0; l < LINES; ++l) {
+        const auto& s = mux.line_stats(l);
+        // Drain and verify: monotonically increasing record stream with
+        // exactly the gapped packets missing
+        MarketData md;
+        uint64_t drained = 0;
+        uint64_t last = 0;
+        bool monotonic = true;
+        while (mux.line_output(l).pop(md)) {
+            if (drained > 0 && md.timestamp <= last) monotonic = false;
+            last = md.timestamp;
+            ++drained;
+        }
+        ok = ok && monotonic && drained == s.packets * RECORDS_PER_PACKET
+             && s.packets + s.gaps == PACKETS_PER_LINE;
+        std::cout << "line " << l << ": " << s.packets << " packets, "
+                  << s.duplicates << " dup legs dropped, " << s.gaps
+                  << " gapped (for recovery), " << drained << " records "
+                  << (monotonic ? "monotonic" : "ORDER BROKEN") << "\n";
+    }
+    std::cout << (ok ? "ARBITRATION CONSISTENT\n" : "ARBITRATION MISMATCH\n");
+    return ok ? 0 : 1;
+}
@@ -1,42 +1,217 @@
+// Batched UDP multicast market-data handler.
+// Compile: g++ -std=c++17 -O2 MarketFeed.cpp -o MarketFeed -pthread
+//
+// The original mock paid one read() syscall per message — at exchange message
+// rates the syscall alone dwarfs the decode. This version drains the socket
+// with recvmmsg() into a ring of pre-registered receive buffers (up to
+// BATCH_SIZE datagrams per syscall), frames records in place as
+// const MarketData* with no copy or parse step, and feeds them into the
+// Fifo3 pipeline the book consumes from.
+
 #include <iostream>
+#include <atomic>
 #include <chrono>
+#include <thread>
 #include <vector>
 #include <cstring>
+#include <arpa/inet.h>
+#include <netinet/in.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include "../../SPSC_QUEUES/spsc_q3.cpp"
+
 struct MarketData {
     uint64_t timestamp;
     double price;
     uint32_t volume;
 };
 
-// Parsing function (works on raw bytes, no extra allocations)
-inline MarketData parse(const char* buffer) {
-    MarketData data;
-    std::memcpy(&data, buffer, sizeof(MarketData));
-    return data;
-}
+// Records are framed straight out of the receive buffers, so the wire bytes
+// are the struct: pin the layout
+static_assert(sizeof(MarketData) == 24, "MarketData layout changed");
+static_assert(std::is_trivially_copyable<MarketData>::value);
 
-int main() {
-    char buffer[sizeof(MarketData)];
-    int sock = socket(AF_INET, SOCK_STREAM, 0);
-    // Assume already connected...
+// ---------------- batched receiver ----------------
 
-    auto start = std::chrono::high_resolution_clock::now();
+class BatchedMarketFeed {
+public:
+    static constexpr size_t BATCH_SIZE = 32;      // datagrams per recvmmsg
+    static constexpr size_t MAX_DATAGRAM = 1472;  // ethernet MTU minus headers
+
+    BatchedMarketFeed(const char* group, uint16_t port) {
+        sock_ = socket(AF_INET, SOCK_DGRAM, 0);
+        if (sock_ < 0) {
+            perror("socket");
+            std::exit(1);
+        }
+
+        int reuse = 1;
+        setsockopt(sock_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        // A burst can outrun the consumer momentarily; a deep kernel buffer
+        // absorbs it instead of dropping datagrams
+        int rcvbuf = 4 * 1024 * 1024;
+        setsockopt(sock_, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons(port);
+        if (bind(sock_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            perror("bind");
+            std::exit(1);
+        }
+
+        ip_mreq mreq{};
+        mreq.imr_multiaddr.s_addr = inet_addr(group);
+        mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+        if (setsockopt(sock_, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0) {
+            perror("IP_ADD_MEMBERSHIP");
+            std::exit(1);
+        }
+
+        // Register the buffer ring with the mmsghdr array once; every
+        // recvmmsg after this reuses the same iovecs
+        for (size_t i = 0; i < BATCH_SIZE; i++) {
+            iovecs_[i].iov_base = buffers_[i].bytes;
+            iovecs_[i].iov_len = MAX_DATAGRAM;
+            std::memset(&headers_[i], 0, sizeof(headers_[i]));
+            headers_[i].msg_hdr.msg_iov = &iovecs_[i];
+            headers_[i].msg_hdr.msg_iovlen = 1;
+        }
+    }
+
+    ~BatchedMarketFeed() { close(sock_); }
+
+    // Drain up to BATCH_SIZE datagrams in one syscall and hand each one to
+    // the handler as a framed record span pointing INTO the receive buffer:
+    // handler(const MarketData* records, size_t count). The span is only
+    // valid until the next poll().
+    // Returns the number of datagrams processed; 0 on timeout.
+    template<typename Handler>
+    size_t poll(Handler&& handler, int timeout_ms = 100) {
+        timespec timeout{timeout_ms / 1000, (timeout_ms % 1000) * 1000000L};
+        int n = recvmmsg(sock_, headers_, BATCH_SIZE, MSG_WAITFORONE, &timeout);
+        if (n <= 0) {
+            return 0;
+        }
+
+        for (int i = 0; i < n; i++) {
+            size_t bytes = headers_[i].msg_len;
+            handler(reinterpret_cast<const MarketData*>(buffers_[i].bytes),
+                    bytes / sizeof(MarketData));
+        }
+        return static_cast<size_t>(n);
+    }
+
+private:
+    // Receive slots aligned so the in-place MarketData cast is valid
+    struct alignas(alignof(MarketData)) Buffer {
+        char bytes[MAX_DATAGRAM];
+    };
+
+    int sock_;
+    Buffer buffers_[BATCH_SIZE];
+    iovec iovecs_[BATCH_SIZE];
+    mmsghdr headers_[BATCH_SIZE];
+};
+
+// ---------------- mock publisher ----------------
+
+// Stands in for the exchange: packs RECORDS_PER_PACKET records per datagram
+// and blasts them at the multicast group
+class FeedPublisher {
+public:
+    static constexpr size_t RECORDS_PER_PACKET = 50;
 
-    for (int i = 0; i < 1000000; i++) {
-        read(sock, buffer, sizeof(buffer));
-        MarketData md = parse(buffer);
-        // Decision logic here (fast math, no heap allocation)
+    FeedPublisher(const char* group, uint16_t port) {
+        sock_ = socket(AF_INET, SOCK_DGRAM, 0);
+        unsigned char loop = 1;
+        setsockopt(sock_, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+        dest_.sin_family = AF_INET;
+        dest_.sin_addr.s_addr = inet_addr(group);
+        dest_.sin_port = htons(port);
     }
 
+    ~FeedPublisher() { close(sock_); }
+
+    void publish(const MarketData* records, size_t count) {
+        sendto(sock_, records, count * sizeof(MarketData), 0,
+               reinterpret_cast<sockaddr*>(&dest_), sizeof(dest_));
+    }
+
+private:
+    int sock_;
+    sockaddr_in dest_{};
+};
+
+// ---------------- demo ----------------
+
+int main() {
+    const char* GROUP = "239.255.0.1";
+    const uint16_t PORT = 30001;
+    const size_t NUM_PACKETS = 2000;
+    const size_t TOTAL_RECORDS = NUM_PACKETS * FeedPublisher::RECORDS_PER_PACKET;
+
+    BatchedMarketFeed feed(GROUP, PORT);
+    Fifo3<MarketData> pipeline(1 << 17);  // sized to absorb the whole burst
+
+    // Publisher thread: the "exchange" side
+    std::thread publisher([&]() {
+        FeedPublisher pub(GROUP, PORT);
+        MarketData packet[FeedPublisher::RECORDS_PER_PACKET];
+        uint64_t seq = 0;
+        for (size_t p = 0; p < NUM_PACKETS; p++) {
+            for (size_t r = 0; r < FeedPublisher::RECORDS_PER_PACKET; r++) {
+                packet[r] = {seq++, 100.0 + (seq % 200) * 0.01,
+                             static_cast<uint32_t>(1 + seq % 500)};
+            }
+            pub.publish(packet, FeedPublisher::RECORDS_PER_PACKET);
+            if (p % 100 == 0) {
+                // Brief yield so a single-core box lets the receiver drain
+                std::this_thread::sleep_for(std::chrono::microseconds(500));
+            }
+        }
+    });
+
+    // Receive loop: recvmmsg batches -> zero-copy framing -> fifo
+    size_t received = 0;
+    size_t batches = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    int idle_polls = 0;
+    while (received < TOTAL_RECORDS && idle_polls < 5) {
+        size_t datagrams = feed.poll([&](const MarketData* records, size_t count) {
+            for (size_t i = 0; i < count; i++) {
+                while (!pipeline.push(records[i])) { /* consumer behind */ }
+            }
+            received += count;
+        });
+        if (datagrams == 0) {
+            idle_polls++;  // publisher done or packets dropped
+        } else {
+            idle_polls = 0;
+            batches++;
+        }
+    }
     auto end = std::chrono::high_resolution_clock::now();
-    std::cout << "Elapsed: "
-              << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()
-              << " us\n";
+    publisher.join();
+
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    std::cout << "Received " << received << "/" << TOTAL_RECORDS << " records in "
+              << batches << " recvmmsg calls ("
+              << (batches ? received / batches : 0) << " records/syscall avg)\n";
+    std::cout << "Elapsed: " << micros << " us ("
+              << (received * 1000000.0) / micros << " records/sec)\n";
 
-    close(sock);
+    // Drain the pipeline and verify the stream arrived intact and in order
+    MarketData md;
+    uint64_t expected = 0;
+    bool ordered = true;
+    while (pipeline.pop(md)) {
+        if (md.timestamp != expected++) ordered = false;
+    }
+    std::cout << "Pipeline drained " << expected << " records, "
+              << (ordered ? "in order" : "ORDER BROKEN") << "\n";
     return 0;
 }
-
@@ -0,0 +1,210 @@
+// fifo_bench - comparison harness for the Fifo1..Fifo5 queue generations
+// Compile: g++ -std=c++17 -O3 -march=native fifo_bench.cpp -o fifo_bench -pthread
+// Run:     ./fifo_bench [ops] [producer_core] [consumer_core]
+//
+// The spsc_q*.cpp files are header-style (#pragma once) but there was no
+// driver to compare them, so the payoff of each generation's trick — atomic
+// cursors (2), cache-line separation (3), cached cursors + batching (4),
+// power-of-two masking (5) — was folklore rather than a number. This binary
+// runs every variant through identical producer/consumer workloads across
+// element sizes and burst patterns and prints ops/sec plus sampled p50/p99
+// inter-thread latency. Run it per deployment host: the false-sharing payoff
+// differs wildly between microarchitectures.
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+
+#include "spsc_q1.cpp"
+#include "spsc_q2.cpp"
+#include "spsc_q3.cpp"
+#include "spsc_q4.cpp"
+#include "spsc_q5.cpp"
+
+// ---------------- workload plumbing ----------------
+
+// Element with a timestamp slot and a configurable footprint; PadBytes
+// models the difference between an 8-byte ticket and a full message struct
+template<std::size_t PadBytes>
+struct Element {
+    uint64_t stamp;  // 0 = unsampled, else producer steady_clock ns
+    char pad[PadBytes];
+};
+template<> struct Element<0> { uint64_t stamp; };
+
+constexpr std::size_t QUEUE_CAPACITY = 1024;   // power of two for Fifo5
+constexpr std::size_t LATENCY_SAMPLE_EVERY = 256;
+
+inline uint64_t now_ns() {
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+}
+
+// Best-effort pinning; harmless on boxes with fewer cores or no permission
+inline void pin_current_thread(int core) {
+    if (core < 0) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+struct BenchResult {
+    double ops_per_sec;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+};
+
+void print_row(const char* name, std::size_t elem_size, std::size_t burst,
+               const BenchResult& r) {
+    std::cout << "  " << std::left << std::setw(8) << name
+              << std::right << std::setw(5) << elem_size << " B"
+              << std::setw(7) << burst << "  "
+              << std::setw(12) << std::fixed << std::setprecision(0) << r.ops_per_sec
+              << std::setw(10) << r.p50_ns
+              << std::setw(10) << r.p99_ns << "\n";
+}
+
+// ---------------- drivers ----------------
+
+// Threaded SPSC run: producer pushes `ops` elements stamping every Nth,
+// consumer records the cross-thread delivery delay of stamped ones.
+// Burst > 1 uses push_n/pop_n when the fifo has them, else tight loops.
+template<typename Fifo, bool HasBatch>
+BenchResult run_spsc(Fifo& fifo, std::size_t ops, std::size_t burst,
+                     int producer_core, int consumer_core) {
+    using Elem = typename Fifo::value_type;
+    std::vector<uint64_t> samples;
+    samples.reserve(ops / LATENCY_SAMPLE_EVERY + 1);
+
+    auto start = now_ns();
+
+    std::thread producer([&]() {
+        pin_current_thread(producer_core);
+        std::vector<Elem> batch(burst);
+        std::size_t sent = 0;
+        while (sent < ops) {
+            std::size_t n = std::min(burst, ops - sent);
+            for (std::size_t i = 0; i < n; ++i) {
+                batch[i].stamp = ((sent + i) % LATENCY_SAMPLE_EVERY == 0) ? now_ns() : 0;
+            }
+            if constexpr (HasBatch) {
+                std::size_t pushed = 0;
+                while (pushed < n) {
+                    pushed += fifo.push_n(batch.data() + pushed, n - pushed);
+                }
+            } else {
+                for (std::size_t i = 0; i < n; ++i) {
+                    while (!fifo.push(batch[i])) { }
+                }
+            }
+            sent += n;
+        }
+    });
+
+    std::thread consumer([&]() {
+        pin_current_thread(consumer_core);
+        std::vector<Elem> batch(burst);
+        std::size_t got = 0;
+        while (got < ops) {
+            std::size_t n = 0;
+            if constexpr (HasBatch) {
+                while ((n = fifo.pop_n(batch.data(), burst)) == 0) { }
+            } else {
+                while (!fifo.pop(batch[0])) { }
+                n = 1;
+            }
+            uint64_t arrival = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                if (batch[i].stamp != 0) {
+                    if (arrival == 0) arrival = now_ns();
+                    samples.push_back(arrival - batch[i].stamp);
+                }
+            }
+            got += n;
+        }
+    });
+
+    producer.join();
+    consumer.join();
+    auto elapsed = now_ns() - start;
+
+    std::sort(samples.begin(), samples.end());
+    BenchResult r{};
+    r.ops_per_sec = ops * 1e9 / elapsed;
+    if (!samples.empty()) {
+        r.p50_ns = samples[samples.size() / 2];
+        r.p99_ns = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+    }
+    return r;
+}
+
+// Fifo1 is not threadsafe: run it single-threaded (alternating push/pop) as
+// the no-synchronization baseline the others are paying against
+template<typename Fifo>
+BenchResult run_single_threaded(Fifo& fifo, std::size_t ops) {
+    using Elem = typename Fifo::value_type;
+    Elem e{};
+    auto start = now_ns();
+    for (std::size_t i = 0; i < ops; ++i) {
+        fifo.push(e);
+        fifo.pop(e);
+    }
+    auto elapsed = now_ns() - start;
+    return BenchResult{ops * 1e9 / elapsed, 0, 0};
+}
+
+// ---------------- matrix ----------------
+
+template<std::size_t PadBytes>
+void run_size_class(std::size_t ops, int producer_core, int consumer_core) {
+    using Elem = Element<PadBytes>;
+    constexpr std::size_t elem_size = sizeof(Elem);
+
+    {
+        Fifo1<Elem> fifo(QUEUE_CAPACITY);
+        print_row("Fifo1*", elem_size, 1, run_single_threaded(fifo, ops));
+    }
+    {
+        Fifo2<Elem> fifo(QUEUE_CAPACITY);
+        print_row("Fifo2", elem_size, 1,
+                  run_spsc<Fifo2<Elem>, false>(fifo, ops, 1, producer_core, consumer_core));
+    }
+    {
+        Fifo3<Elem> fifo(QUEUE_CAPACITY);
+        print_row("Fifo3", elem_size, 1,
+                  run_spsc<Fifo3<Elem>, false>(fifo, ops, 1, producer_core, consumer_core));
+    }
+    for (std::size_t burst : {std::size_t{1}, std::size_t{32}}) {
+        Fifo4<Elem> fifo(QUEUE_CAPACITY);
+        print_row("Fifo4", elem_size, burst,
+                  run_spsc<Fifo4<Elem>, true>(fifo, ops, burst, producer_core, consumer_core));
+    }
+    {
+        Fifo5<Elem, QUEUE_CAPACITY> fifo;
+        print_row("Fifo5", elem_size, 1,
+                  run_spsc<Fifo5<Elem, QUEUE_CAPACITY>, false>(fifo, ops, 1,
+                                                               producer_core, consumer_core));
+    }
+}
+
+int main(int argc, char** argv) {
+    std::size_t ops = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    int producer_core = argc > 2 ? std::atoi(argv[2]) : -1;
+    int consumer_core = argc > 3 ? std::atoi(argv[3]) : -1;
+
+    std::cout << "fifo_bench: " << ops << " ops/queue, cores "
+              << producer_core << "/" << consumer_core
+              << " (-1 = unpinned), capacity " << QUEUE_CAPACITY << "\n";
+    std::cout << "  queue    elem   burst       ops/sec   p50(ns)   p99(ns)\n";
+    std::cout << "  (* single-threaded baseline, no latency)\n";
+
+    run_size_class<0>(ops, producer_core, consumer_core);    // 8 B ticket
+    run_size_class<56>(ops, producer_core, consumer_core);   // 64 B message
+    return 0;
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+
+/// Threadsafe bounded multi-producer multi-consumer FIFO
+///
+/// The SPSC fifos assume exactly one thread on each end; this sibling serves
+/// fan-in paths like multiple strategy threads feeding one exchange session.
+/// Each ring slot carries a sequence number (Vyukov's design): a producer
+/// claims a slot with a single fetch_add-style CAS on the push cursor, writes
+/// the element, then publishes by bumping the slot sequence, so producers
+/// never spin on a shared lock and contend only on the cursor word.
+template<typename T, typename Alloc = std::allocator<T>>
+class MpmcQueue
+{
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    explicit MpmcQueue(size_type capacity)
+        : capacity_{capacity}
+        , slots_{new Slot[capacity]}
+    {
+        for (size_type i = 0; i < capacity_; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcQueue(MpmcQueue const&) = delete;
+    MpmcQueue& operator=(MpmcQueue const&) = delete;
+
+    ~MpmcQueue() {
+        T value;
+        while (pop(value)) {}
+        delete[] slots_;
+    }
+
+
+    /// Returns an estimate of the number of elements in the queue.
+    /// Exact only when no other thread is pushing or popping.
+    auto size() const noexcept {
+        auto pushCursor = pushCursor_.load(std::memory_order_relaxed);
+        auto popCursor = popCursor_.load(std::memory_order_relaxed);
+        return pushCursor >= popCursor ? pushCursor - popCursor : size_type{0};
+    }
+
+    /// Returns whether the container has no elements
+    auto empty() const noexcept { return size() == 0; }
+
+    /// Returns whether the container has capacity() elements
+    auto full() const noexcept { return size() == capacity(); }
+
+    /// Returns the number of elements that can be held in the queue
+    auto capacity() const noexcept { return capacity_; }
+
+
+    /// Push one object onto the queue from any thread.
+    /// @return `true` if the operation is successful; `false` if queue is full.
+    auto push(T const& value) {
+        auto pushCursor = pushCursor_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pushCursor % capacity_];
+            auto sequence = slot.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(sequence)
+                      - static_cast<std::intptr_t>(pushCursor);
+
+            if (diff == 0) {
+                // Slot is free for this cursor value; try to claim it
+                if (pushCursor_.compare_exchange_weak(pushCursor, pushCursor + 1,
+                                                      std::memory_order_relaxed)) {
+                    new (&slot.storage) T(value);
+                    slot.sequence.store(pushCursor + 1, std::memory_order_release);
+                    return true;
+                }
+                // CAS failed: pushCursor was reloaded, retry with the new value
+            } else if (diff < 0) {
+                // Slot still holds an unconsumed element: queue is full
+                return false;
+            } else {
+                // Another producer claimed this slot first; reload and retry
+                pushCursor = pushCursor_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Pop one object from the queue from any thread.
+    /// @return `true` if the pop operation is successful; `false` if queue is empty.
+    auto pop(T& value) {
+        auto popCursor = popCursor_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[popCursor % capacity_];
+            auto sequence = slot.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(sequence)
+                      - static_cast<std::intptr_t>(popCursor + 1);
+
+            if (diff == 0) {
+                if (popCursor_.compare_exchange_weak(popCursor, popCursor + 1,
+                                                     std::memory_order_relaxed)) {
+                    T* element = reinterpret_cast<T*>(&slot.storage);
+                    value = *element;
+                    element->~T();
+                    // Free the slot for the producer one lap ahead
+                    slot.sequence.store(popCursor + capacity_, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                // Slot not yet published: queue is empty
+                return false;
+            } else {
+                popCursor = popCursor_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    using CursorType = std::atomic<size_type>;
+    static_assert(CursorType::is_always_lock_free);
+
+    // See spsc_q3.cpp for why std::hardware_destructive_interference_size
+    // is not used directly
+    static constexpr auto hardware_destructive_interference_size = size_type{64};
+
+    /// Ring slot: per-slot sequence number plus in-place element storage.
+    /// Each slot gets its own cache line so producers working on adjacent
+    /// slots do not false-share.
+    struct alignas(hardware_destructive_interference_size) Slot {
+        std::atomic<size_type> sequence;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    size_type capacity_;
+    Slot* slots_;
+
+    /// Claimed by producers via CAS
+    alignas(hardware_destructive_interference_size) CursorType pushCursor_{};
+
+    /// Claimed by consumers via CAS
+    alignas(hardware_destructive_interference_size) CursorType popCursor_{};
+
+    // Padding to avoid false sharing with adjacent objects
+    char padding_[hardware_destructive_interference_size - sizeof(CursorType)];
+};
@@ -76,8 +76,8 @@ private:
     static_assert(CursorType::is_always_lock_free);
 
     /// Loaded and stored by the push thread; loaded by the pop thread
-    CursorType pushCursor_;
+    CursorType pushCursor_{};
 
     /// Loaded and stored by the pop thread; loaded by the push thread
-    CursorType popCursor_;
+    CursorType popCursor_{};
 };
@@ -4,6 +4,9 @@
 #include <cassert>
 #include <memory>
 #include <new>
+#include <utility>
+
+#include "wait_policies.cpp"
 
 
 /// Threadsafe, efficient circular FIFO
@@ -51,18 +54,29 @@ public:
 
     /// Push one object onto the fifo.
     /// @return `true` if the operation is successful; `false` if fifo is full.
-    auto push(T const& value) {
+    auto push(T const& value) { return emplace(value); }
+
+    /// Move one object onto the fifo; the ring slot steals the payload.
+    /// The value is only moved from when the push succeeds.
+    auto push(T&& value) { return emplace(std::move(value)); }
+
+    /// Construct an element directly in the ring slot from `args` — no
+    /// temporary, no copy (L6/movesemantics.cpp shows what that copy costs
+    /// once T carries an owning member).
+    /// @return `true` if the operation is successful; `false` if fifo is full.
+    template<typename... Args>
+    auto emplace(Args&&... args) {
         auto pushCursor = pushCursor_.load(std::memory_order_relaxed);
         auto popCursor = popCursor_.load(std::memory_order_acquire);
         if (full(pushCursor, popCursor)) {
             return false;
         }
-        new (element(pushCursor)) T(value);
+        new (element(pushCursor)) T(std::forward<Args>(args)...);
         pushCursor_.store(pushCursor + 1, std::memory_order_release);
         return true;
     }
 
-    /// Pop one object from the fifo.
+    /// Pop one object from the fifo; the payload is moved out of the slot.
     /// @return `true` if the pop operation is successful; `false` if fifo is empty.
     auto pop(T& value) {
         auto pushCursor = pushCursor_.load(std::memory_order_acquire);
@@ -70,12 +84,39 @@ public:
         if (empty(pushCursor, popCursor)) {
             return false;
         }
-        value = *element(popCursor);
+        value = std::move(*element(popCursor));
         element(popCursor)->~T();
         popCursor_.store(popCursor + 1, std::memory_order_release);
         return true;
     }
 
+
+    /// Push one object, blocking until space is available.
+    /// WaitPolicy (see wait_policies.cpp) controls how the producer waits
+    /// between failed attempts; selected at the call/instantiation site.
+    template<typename WaitPolicy = SpinPausePolicy>
+    void push_wait(T const& value, WaitPolicy policy = WaitPolicy{}) {
+        while (not push(value)) {
+            policy.wait();
+        }
+    }
+
+    /// Move-in variant; safe to retry because a failed push never moves
+    template<typename WaitPolicy = SpinPausePolicy>
+    void push_wait(T&& value, WaitPolicy policy = WaitPolicy{}) {
+        while (not push(std::move(value))) {
+            policy.wait();
+        }
+    }
+
+    /// Pop one object, blocking until an element is available.
+    template<typename WaitPolicy = SpinPausePolicy>
+    void pop_wait(T& value, WaitPolicy policy = WaitPolicy{}) {
+        while (not pop(value)) {
+            policy.wait();
+        }
+    }
+
 private:
     auto full(size_type pushCursor, size_type popCursor) const noexcept {
         return (pushCursor - popCursor) == capacity_;
@@ -103,10 +144,10 @@ private:
     static constexpr auto hardware_destructive_interference_size = size_type{64};
 
     /// Loaded and stored by the push thread; loaded by the pop thread
-    alignas(hardware_destructive_interference_size) CursorType pushCursor_;
+    alignas(hardware_destructive_interference_size) CursorType pushCursor_{};
 
     /// Loaded and stored by the pop thread; loaded by the push thread
-    alignas(hardware_destructive_interference_size) CursorType popCursor_;
+    alignas(hardware_destructive_interference_size) CursorType popCursor_{};
 
     // Padding to avoid false sharing with adjacent objects
     char padding_[hardware_destructive_interference_size - sizeof(size_type)];
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "wait_policies.cpp"
+
+
+/// Threadsafe, efficient circular FIFO with cached cursors and batch ops
+///
+/// Fifo3 loads the opposing cursor with acquire semantics on every push/pop,
+/// so producer and consumer bounce each other's cache lines once per element.
+/// Each side here keeps a locally cached copy of the opposing cursor and only
+/// re-reads the shared atomic when the cached value says full/empty; push_n/
+/// pop_n move whole spans of elements per cursor update.
+template<typename T, typename Alloc = std::allocator<T>>
+class Fifo4 : private Alloc
+{
+public:
+    using value_type = T;
+    using allocator_traits = std::allocator_traits<Alloc>;
+    using size_type = typename allocator_traits::size_type;
+
+    explicit Fifo4(size_type capacity, Alloc const& alloc = Alloc{})
+        : Alloc{alloc}
+        , capacity_{capacity}
+        , ring_{allocator_traits::allocate(*this, capacity)}
+    {}
+
+    ~Fifo4() {
+        while(not empty()) {
+            element(popCursor_)->~T();
+            ++popCursor_;
+        }
+        allocator_traits::deallocate(*this, ring_, capacity_);
+    }
+
+
+    /// Returns the number of elements in the fifo
+    auto size() const noexcept {
+        auto pushCursor = pushCursor_.load(std::memory_order_relaxed);
+        auto popCursor = popCursor_.load(std::memory_order_relaxed);
+
+        assert(popCursor <= pushCursor);
+        return pushCursor - popCursor;
+    }
+
+    /// Returns whether the container has no elements
+    auto empty() const noexcept { return size() == 0; }
+
+    /// Returns whether the container has capacity_() elements
+    auto full() const noexcept { return size() == capacity(); }
+
+    /// Returns the number of elements that can be held in the fifo
+    auto capacity() const noexcept { return capacity_; }
+
+
+    /// Push one object onto the fifo.
+    /// @return `true` if the operation is successful; `false` if fifo is full.
+    auto push(T const& value) { return emplace(value); }
+
+    /// Move one object onto the fifo; the ring slot steals the payload.
+    /// The value is only moved from when the push succeeds.
+    auto push(T&& value) { return emplace(std::move(value)); }
+
+    /// Construct an element directly in the ring slot from `args` — no
+    /// temporary, no copy for movable payloads.
+    /// @return `true` if the operation is successful; `false` if fifo is full.
+    template<typename... Args>
+    auto emplace(Args&&... args) {
+        auto pushCursor = pushCursor_.load(std::memory_order_relaxed);
+        if (full(pushCursor, popCursorCached_)) {
+            // Only now pay for the cross-core read of the consumer's cursor
+            popCursorCached_ = popCursor_.load(std::memory_order_acquire);
+            if (full(pushCursor, popCursorCached_)) {
+                return false;
+            }
+        }
+        new (element(pushCursor)) T(std::forward<Args>(args)...);
+        pushCursor_.store(pushCursor + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Pop one object from the fifo; the payload is moved out of the slot.
+    /// @return `true` if the pop operation is successful; `false` if fifo is empty.
+    auto pop(T& value) {
+        auto popCursor = popCursor_.load(std::memory_order_relaxed);
+        if (empty(pushCursorCached_, popCursor)) {
+            pushCursorCached_ = pushCursor_.load(std::memory_order_acquire);
+            if (empty(pushCursorCached_, popCursor)) {
+                return false;
+            }
+        }
+        value = std::move(*element(popCursor));
+        element(popCursor)->~T();
+        popCursor_.store(popCursor + 1, std::memory_order_release);
+        return true;
+    }
+
+
+    /// Push one object, blocking until space is available.
+    /// WaitPolicy (see wait_policies.cpp) controls how the producer waits
+    /// between failed attempts; selected at the call/instantiation site.
+    template<typename WaitPolicy = SpinPausePolicy>
+    void push_wait(T const& value, WaitPolicy policy = WaitPolicy{}) {
+        while (not push(value)) {
+            policy.wait();
+        }
+    }
+
+    /// Move-in variant; safe to retry because a failed push never moves
+    template<typename WaitPolicy = SpinPausePolicy>
+    void push_wait(T&& value, WaitPolicy policy = WaitPolicy{}) {
+        while (not push(std::move(value))) {
+            policy.wait();
+        }
+    }
+
+    /// Pop one object, blocking until an element is available.
+    template<typename WaitPolicy = SpinPausePolicy>
+    void pop_wait(T& value, WaitPolicy policy = WaitPolicy{}) {
+        while (not pop(value)) {
+            policy.wait();
+        }
+    }
+
+    /// Push up to `count` objects from `values` with one cursor update.
+    /// @return the number of objects actually pushed (0 if fifo is full).
+    size_type push_n(T const* values, size_type count) {
+        auto pushCursor = pushCursor_.load(std::memory_order_relaxed);
+        auto free = capacity_ - (pushCursor - popCursorCached_);
+        if (free < count) {
+            popCursorCached_ = popCursor_.load(std::memory_order_acquire);
+            free = capacity_ - (pushCursor - popCursorCached_);
+        }
+
+        auto n = std::min(count, free);
+        for (size_type i = 0; i < n; ++i) {
+            new (element(pushCursor + i)) T(values[i]);
+        }
+        if (n) {
+            pushCursor_.store(pushCursor + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+    /// Pop up to `count` objects into `values` with one cursor update.
+    /// @return the number of objects actually popped (0 if fifo is empty).
+    size_type pop_n(T* values, size_type count) {
+        auto popCursor = popCursor_.load(std::memory_order_relaxed);
+        auto available = pushCursorCached_ - popCursor;
+        if (available < count) {
+            pushCursorCached_ = pushCursor_.load(std::memory_order_acquire);
+            available = pushCursorCached_ - popCursor;
+        }
+
+        auto n = std::min(count, available);
+        for (size_type i = 0; i < n; ++i) {
+            values[i] = std::move(*element(popCursor + i));
+            element(popCursor + i)->~T();
+        }
+        if (n) {
+            popCursor_.store(popCursor + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+private:
+    auto full(size_type pushCursor, size_type popCursor) const noexcept {
+        return (pushCursor - popCursor) == capacity_;
+    }
+    static auto empty(size_type pushCursor, size_type popCursor) noexcept {
+        return pushCursor == popCursor;
+    }
+    auto element(size_type cursor) noexcept {
+        return &ring_[cursor % capacity_];
+    }
+
+private:
+    size_type capacity_;
+    T* ring_;
+
+    using CursorType = std::atomic<size_type>;
+    static_assert(CursorType::is_always_lock_free);
+
+    // See spsc_q3.cpp for why std::hardware_destructive_interference_size
+    // is not used directly
+    static constexpr auto hardware_destructive_interference_size = size_type{64};
+
+    /// Loaded and stored by the push thread; loaded by the pop thread
+    alignas(hardware_destructive_interference_size) CursorType pushCursor_{};
+
+    /// Producer-local cached copy of popCursor_; lags the true value
+    alignas(hardware_destructive_interference_size) size_type popCursorCached_{};
+
+    /// Loaded and stored by the pop thread; loaded by the push thread
+    alignas(hardware_destructive_interference_size) CursorType popCursor_{};
+
+    /// Consumer-local cached copy of pushCursor_; lags the true value
+    alignas(hardware_destructive_interference_size) size_type pushCursorCached_{};
+
+    // Padding to avoid false sharing with adjacent objects
+    char padding_[hardware_destructive_interference_size - sizeof(size_type)];
+};
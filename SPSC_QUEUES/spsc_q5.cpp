@@ -0,0 +1,171 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "wait_policies.cpp"
+
+
+/// Threadsafe circular FIFO with compile-time power-of-two capacity
+///
+/// Fifo1-4 compute `cursor % capacity_` with a runtime modulo in element() —
+/// an integer divide in the hottest two functions in the pipeline. Making the
+/// capacity a template non-type parameter and requiring a power of two turns
+/// the modulo into a bitwise AND with a compile-time mask. Use this variant
+/// for latency-critical instantiations (e.g. the market-data queue); Fifo4
+/// remains the runtime-capacity choice.
+template<typename T, std::size_t Capacity, typename Alloc = std::allocator<T>>
+class Fifo5 : private Alloc
+{
+    static_assert(Capacity > 0, "Fifo5 capacity must be non-zero");
+    static_assert((Capacity & (Capacity - 1)) == 0,
+                  "Fifo5 capacity must be a power of two");
+
+public:
+    using value_type = T;
+    using allocator_traits = std::allocator_traits<Alloc>;
+    using size_type = typename allocator_traits::size_type;
+
+    explicit Fifo5(Alloc const& alloc = Alloc{})
+        : Alloc{alloc}
+        , ring_{allocator_traits::allocate(*this, Capacity)}
+    {}
+
+    ~Fifo5() {
+        while(not empty()) {
+            element(popCursor_)->~T();
+            ++popCursor_;
+        }
+        allocator_traits::deallocate(*this, ring_, Capacity);
+    }
+
+
+    /// Returns the number of elements in the fifo
+    auto size() const noexcept {
+        auto pushCursor = pushCursor_.load(std::memory_order_relaxed);
+        auto popCursor = popCursor_.load(std::memory_order_relaxed);
+
+        assert(popCursor <= pushCursor);
+        return pushCursor - popCursor;
+    }
+
+    /// Returns whether the container has no elements
+    auto empty() const noexcept { return size() == 0; }
+
+    /// Returns whether the container has capacity() elements
+    auto full() const noexcept { return size() == capacity(); }
+
+    /// Returns the number of elements that can be held in the fifo
+    static constexpr auto capacity() noexcept { return size_type{Capacity}; }
+
+
+    /// Push one object onto the fifo.
+    /// @return `true` if the operation is successful; `false` if fifo is full.
+    auto push(T const& value) { return emplace(value); }
+
+    /// Move one object onto the fifo; the ring slot steals the payload.
+    /// The value is only moved from when the push succeeds.
+    auto push(T&& value) { return emplace(std::move(value)); }
+
+    /// Construct an element directly in the ring slot from `args` — no
+    /// temporary, no copy for movable payloads.
+    /// @return `true` if the operation is successful; `false` if fifo is full.
+    template<typename... Args>
+    auto emplace(Args&&... args) {
+        auto pushCursor = pushCursor_.load(std::memory_order_relaxed);
+        if (full(pushCursor, popCursorCached_)) {
+            popCursorCached_ = popCursor_.load(std::memory_order_acquire);
+            if (full(pushCursor, popCursorCached_)) {
+                return false;
+            }
+        }
+        new (element(pushCursor)) T(std::forward<Args>(args)...);
+        pushCursor_.store(pushCursor + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Pop one object from the fifo; the payload is moved out of the slot.
+    /// @return `true` if the pop operation is successful; `false` if fifo is empty.
+    auto pop(T& value) {
+        auto popCursor = popCursor_.load(std::memory_order_relaxed);
+        if (empty(pushCursorCached_, popCursor)) {
+            pushCursorCached_ = pushCursor_.load(std::memory_order_acquire);
+            if (empty(pushCursorCached_, popCursor)) {
+                return false;
+            }
+        }
+        value = std::move(*element(popCursor));
+        element(popCursor)->~T();
+        popCursor_.store(popCursor + 1, std::memory_order_release);
+        return true;
+    }
+
+
+    /// Push one object, blocking until space is available.
+    /// WaitPolicy (see wait_policies.cpp) controls how the producer waits
+    /// between failed attempts; selected at the call/instantiation site.
+    template<typename WaitPolicy = SpinPausePolicy>
+    void push_wait(T const& value, WaitPolicy policy = WaitPolicy{}) {
+        while (not push(value)) {
+            policy.wait();
+        }
+    }
+
+    /// Move-in variant; safe to retry because a failed push never moves
+    template<typename WaitPolicy = SpinPausePolicy>
+    void push_wait(T&& value, WaitPolicy policy = WaitPolicy{}) {
+        while (not push(std::move(value))) {
+            policy.wait();
+        }
+    }
+
+    /// Pop one object, blocking until an element is available.
+    template<typename WaitPolicy = SpinPausePolicy>
+    void pop_wait(T& value, WaitPolicy policy = WaitPolicy{}) {
+        while (not pop(value)) {
+            policy.wait();
+        }
+    }
+
+private:
+    static auto full(size_type pushCursor, size_type popCursor) noexcept {
+        return (pushCursor - popCursor) == Capacity;
+    }
+    static auto empty(size_type pushCursor, size_type popCursor) noexcept {
+        return pushCursor == popCursor;
+    }
+    auto element(size_type cursor) noexcept {
+        // Mask instead of divide: Capacity is a compile-time power of two
+        return &ring_[cursor & mask_];
+    }
+
+private:
+    static constexpr size_type mask_ = Capacity - 1;
+
+    T* ring_;
+
+    using CursorType = std::atomic<size_type>;
+    static_assert(CursorType::is_always_lock_free);
+
+    // See spsc_q3.cpp for why std::hardware_destructive_interference_size
+    // is not used directly
+    static constexpr auto hardware_destructive_interference_size = size_type{64};
+
+    /// Loaded and stored by the push thread; loaded by the pop thread
+    alignas(hardware_destructive_interference_size) CursorType pushCursor_{};
+
+    /// Producer-local cached copy of popCursor_; lags the true value
+    alignas(hardware_destructive_interference_size) size_type popCursorCached_{};
+
+    /// Loaded and stored by the pop thread; loaded by the push thread
+    alignas(hardware_destructive_interference_size) CursorType popCursor_{};
+
+    /// Consumer-local cached copy of pushCursor_; lags the true value
+    alignas(hardware_destructive_interference_size) size_type pushCursorCached_{};
+
+    // Padding to avoid false sharing with adjacent objects
+    char padding_[hardware_destructive_interference_size - sizeof(size_type)];
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+/// Waiting policies for the blocking push_wait/pop_wait entry points on the
+/// fifo classes. Every consumer used to re-invent the spin loop around
+/// pop()'s false return, usually either burning a core or sleeping and eating
+/// tens of microseconds of wakeup latency; the policy chosen at instantiation
+/// now decides how a thread waits between failed attempts:
+///
+///   BusySpinPolicy  - pure spin; lowest latency, burns the core. Use when
+///                     the thread owns its core outright.
+///   SpinPausePolicy - spin briefly, then issue a pause instruction per
+///                     retry. The right choice when two hyperthread siblings
+///                     share a physical core: pause yields the core's
+///                     execution resources to the sibling.
+///   SpinFutexPolicy - spin, then pause, then sleep in short futex waits.
+///                     Deepest backoff for queues that go idle; wakeup cost
+///                     is bounded by the futex timeout rather than a
+///                     scheduler round-trip, and the fifo hot path stays
+///                     free of wake syscalls.
+
+/// Architecture pause hint; falls back to a compiler barrier elsewhere
+inline void cpu_pause() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#else
+    asm volatile("" ::: "memory");
+#endif
+}
+
+
+/// Pure busy spin: retry immediately
+class BusySpinPolicy {
+public:
+    void wait() noexcept {}
+};
+
+
+/// Spin a bounded number of times, then pause between retries
+class SpinPausePolicy {
+public:
+    explicit SpinPausePolicy(uint32_t spinLimit = 1024) noexcept
+        : spinLimit_{spinLimit}
+    {}
+
+    void wait() noexcept {
+        if (spins_ < spinLimit_) {
+            ++spins_;
+        } else {
+            cpu_pause();
+        }
+    }
+
+private:
+    uint32_t spinLimit_;
+    uint32_t spins_{};
+};
+
+
+/// Spin, then pause, then sleep in short futex waits. The policy sleeps on a
+/// private word of its own with a timeout instead of requiring the producer
+/// to issue futex wakes, so the fifo's push path is untouched.
+class SpinFutexPolicy {
+public:
+    explicit SpinFutexPolicy(uint32_t spinLimit = 1024,
+                             uint32_t pauseLimit = 4096,
+                             long sleepNanos = 10'000) noexcept
+        : spinLimit_{spinLimit}
+        , pauseLimit_{pauseLimit}
+        , sleepNanos_{sleepNanos}
+    {}
+
+    void wait() noexcept {
+        if (spins_ < spinLimit_) {
+            ++spins_;
+        } else if (spins_ < pauseLimit_) {
+            ++spins_;
+            cpu_pause();
+        } else {
+#if defined(__linux__)
+            struct timespec timeout{0, sleepNanos_};
+            syscall(SYS_futex, &futexWord_, FUTEX_WAIT_PRIVATE,
+                    futexWord_, &timeout, nullptr, 0);
+#else
+            struct timespec timeout{0, sleepNanos_};
+            nanosleep(&timeout, nullptr);
+#endif
+        }
+    }
+
+private:
+    uint32_t spinLimit_;
+    uint32_t pauseLimit_;
+    long sleepNanos_;
+    uint32_t spins_{};
+    uint32_t futexWord_{};
+};
@@ -0,0 +1,255 @@
+// Lock-free linked list with removal and hazard-pointer reclamation.
+// Compile: g++ -std=c++17 -O2 hazardPointerList.cpp -o hazardPointerList -pthread
+//
+// linkedListInsertion.cpp can only insert: there is no remove(), and no way to
+// free a Node while other threads traverse, so it leaks unboundedly. Here the
+// list gets CAS-based removal (mark-then-unlink, Harris/Michael style) and
+// hazard pointers: a reader publishes the node it is about to dereference, a
+// remover retires nodes to a local list and only reclaims the ones no reader
+// has published. Nodes go back to a free pool instead of leaking.
+
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+struct Node {
+    int value;
+    std::atomic<Node*> next;
+    Node(int v) : value(v), next(nullptr) {}
+};
+
+// ---------------- hazard pointer registry ----------------
+
+constexpr int MAX_THREADS = 32;
+constexpr int HP_PER_THREAD = 2;          // curr + prev while traversing
+constexpr size_t RETIRE_THRESHOLD = 64;   // scan after this many retired nodes
+
+struct HazardSlot {
+    std::atomic<Node*> ptr[HP_PER_THREAD];
+};
+
+// One slot per registered thread; slots are never recycled (fine for the
+// pinned-thread processes this is meant for)
+inline HazardSlot g_hazards[MAX_THREADS];
+inline std::atomic<int> g_thread_count{0};
+
+inline int my_slot_index() {
+    thread_local int index = g_thread_count.fetch_add(1);
+    assert(index < MAX_THREADS);
+    return index;
+}
+
+// Publish/clear the hazard pointer for this thread
+inline void protect(int hp, Node* node) {
+    g_hazards[my_slot_index()].ptr[hp].store(node, std::memory_order_release);
+}
+inline void clear_hazards() {
+    for (int i = 0; i < HP_PER_THREAD; i++) {
+        g_hazards[my_slot_index()].ptr[i].store(nullptr, std::memory_order_release);
+    }
+}
+
+inline bool is_protected(Node* node) {
+    int threads = g_thread_count.load(std::memory_order_acquire);
+    for (int t = 0; t < threads; t++) {
+        for (int i = 0; i < HP_PER_THREAD; i++) {
+            if (g_hazards[t].ptr[i].load(std::memory_order_acquire) == node) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Per-thread retire list: unlinked nodes wait here until no hazard pointer
+// references them, then they are deleted (a pool could take them instead)
+inline void retire(Node* node) {
+    thread_local std::vector<Node*> retired;
+    retired.push_back(node);
+
+    if (retired.size() >= RETIRE_THRESHOLD) {
+        std::vector<Node*> still_live;
+        still_live.reserve(retired.size());
+        for (Node* n : retired) {
+            if (is_protected(n)) {
+                still_live.push_back(n);
+            } else {
+                delete n;
+            }
+        }
+        retired.swap(still_live);
+    }
+}
+
+// ---------------- the list ----------------
+
+// next-pointer mark bit: a node whose successor pointer is tagged is logically
+// deleted; physical unlinking happens on the next traversal that sees it
+inline Node* marked(Node* p)   { return reinterpret_cast<Node*>(reinterpret_cast<uintptr_t>(p) | 1); }
+inline Node* unmarked(Node* p) { return reinterpret_cast<Node*>(reinterpret_cast<uintptr_t>(p) & ~uintptr_t{1}); }
+inline bool is_marked(Node* p) { return reinterpret_cast<uintptr_t>(p) & 1; }
+
+class LockFreeList {
+    std::atomic<Node*> head;
+
+public:
+    LockFreeList() : head(nullptr) {}
+
+    void insert(int val) {
+        Node* newNode = new Node(val);
+        Node* oldHead;
+
+        // try until CAS succeeds (same protocol as linkedListInsertion.cpp)
+        do {
+            oldHead = head.load();
+            newNode->next.store(oldHead);
+        } while (!head.compare_exchange_strong(oldHead, newNode));
+    }
+
+    // Remove the first node holding `val`.
+    // Two steps: mark the node's next pointer (logical delete, stops anyone
+    // inserting after it), then CAS it out of the predecessor's next.
+    bool remove(int val) {
+    retry:
+        std::atomic<Node*>* prev = &head;
+        protect(1, nullptr);
+
+        Node* curr = unmarked(prev->load());
+        while (curr) {
+            protect(0, curr);
+            // Re-check: did curr get unlinked between load and protect?
+            if (unmarked(prev->load()) != curr) goto retry;
+
+            Node* next = curr->next.load();
+            if (is_marked(next)) {
+                // Logically deleted by someone else: unlink and retire it
+                if (!prev->compare_exchange_strong(curr, unmarked(next))) goto retry;
+                retire(curr);
+                curr = unmarked(next);
+                continue;
+            }
+
+            if (curr->value == val) {
+                // Logical delete: mark curr's next pointer
+                if (!curr->next.compare_exchange_strong(next, marked(next))) goto retry;
+                // Physical delete: unlink from predecessor (best effort; a
+                // failed CAS just leaves the marked node for later cleanup)
+                if (prev->compare_exchange_strong(curr, unmarked(next))) {
+                    retire(curr);
+                }
+                clear_hazards();
+                return true;
+            }
+
+            prev = &curr->next;
+            protect(1, curr);
+            curr = unmarked(next);
+        }
+
+        clear_hazards();
+        return false;
+    }
+
+    // Same hazard protocol as remove(): publish, then re-read the
+    // predecessor to prove curr was still reachable when the hazard became
+    // visible. Without the re-check a remover can unlink and delete curr in
+    // the window between our load and our protect, and curr->next below
+    // would dereference freed memory.
+    bool contains(int val) {
+    retry:
+        std::atomic<Node*>* prev = &head;
+        protect(1, nullptr);
+
+        Node* curr = unmarked(prev->load());
+        while (curr) {
+            protect(0, curr);
+            // Re-check: did curr get unlinked between load and protect?
+            if (unmarked(prev->load()) != curr) goto retry;
+
+            Node* next = curr->next.load();
+            if (!is_marked(next) && curr->value == val) {
+                clear_hazards();
+                return true;
+            }
+
+            prev = &curr->next;
+            protect(1, curr);
+            curr = unmarked(next);
+        }
+
+        clear_hazards();
+        return false;
+    }
+
+    void print() {
+        Node* curr = unmarked(head.load());
+        while (curr) {
+            if (!is_marked(curr->next.load())) {
+                std::cout << curr->value << " ";
+            }
+            curr = unmarked(curr->next.load());
+        }
+        std::cout << "\n";
+    }
+};
+
+int main() {
+    LockFreeList list;
+
+    // Churn: two inserters and two removers running concurrently, the way a
+    // live subscriber registry churns entries
+    std::thread t1([&]() {
+        for (int i = 1; i <= 1000; i++) list.insert(i);
+    });
+
+    std::thread t2([&]() {
+        for (int i = 1001; i <= 2000; i++) list.insert(i);
+    });
+
+    std::thread t3([&]() {
+        for (int i = 1; i <= 1000; i++) {
+            while (!list.remove(i)) { /* not inserted yet, retry */ }
+        }
+    });
+
+    std::thread t4([&]() {
+        for (int i = 1001; i <= 2000; i++) {
+            while (!list.remove(i)) { }
+        }
+    });
+
+    // Reader racing the churn: every contains() call dereferences nodes the
+    // removers are concurrently retiring, so the hazard re-validation in
+    // contains() is actually exercised (not just the quiet case below)
+    std::atomic<bool> churning{true};
+    std::thread t5([&]() {
+        uint64_t hits = 0, probes = 0;
+        while (churning.load(std::memory_order_acquire)) {
+            for (int i = 1; i <= 2000; i += 97) {
+                hits += list.contains(i);
+                ++probes;
+            }
+        }
+        std::cout << "concurrent reader: " << probes << " contains() probes, "
+                  << hits << " hits during churn\n";
+    });
+
+    t1.join();
+    t2.join();
+    t3.join();
+    t4.join();
+    churning.store(false, std::memory_order_release);
+    t5.join();
+
+    std::cout << "after symmetric insert/remove churn (should be empty): ";
+    list.print();
+
+    list.insert(42);
+    list.insert(7);
+    std::cout << "contains(42): " << list.contains(42)
+              << ", remove(42): " << list.remove(42)
+              << ", contains(42): " << list.contains(42) << "\n";
+    list.print();
+}
@@ -0,0 +1,286 @@
+// async_log.cpp - asynchronous binary logger for the hot process
+// Compile: g++ -std=c++17 -O3 -march=native -DASYNC_LOG_MAIN async_log.cpp -o async_log -pthread
+// Decode:  ./async_log --decode <file.blog>
+//
+// Every diagnostic left enabled in production today goes through std::cout
+// with iomanip (print_book, print_detailed_stats, L2/printing.cpp) — a
+// formatting pass and a write syscall on the calling thread. Here the hot
+// thread's entire cost is one 32-byte record into an SPSC ring: message id,
+// TSC stamp, raw argument words, nothing else. A background thread drains
+// the ring and appends the raw records to a binary file in batches — no
+// formatting anywhere in the trading process. Formatting happens offline:
+// the file carries the format-string table and the TSC calibration in its
+// header, and the --decode mode renders text from that. A full ring drops
+// the record and counts it; tracing must never be the thing that stalls
+// the book.
+
+#pragma once
+#include <fstream>
+#include <thread>
+
+#include "orderbook.cpp"
+
+// ======================== LOG RECORD FORMAT ========================
+
+struct LogRecord {
+    uint16_t id;         // index into the format table
+    uint16_t argc;
+    uint32_t reserved;
+    uint64_t tsc;        // TscClock::cycles() at the call site
+    uint64_t args[2];    // raw words; meaning comes from the format string
+};
+static_assert(sizeof(LogRecord) == 32, "log record layout changed");
+static_assert(std::is_trivially_copyable_v<LogRecord>);
+
+struct LogFileHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t format_count;
+    double ns_per_cycle;     // decoder-side timestamp conversion
+    uint64_t base_tsc;       // cycles at logger start; timestamps are deltas
+
+    static constexpr uint64_t MAGIC = 0x30474C4F42ULL;   // "BOLG0"
+    static constexpr uint32_t VERSION = 1;
+};
+static_assert(sizeof(LogFileHeader) == 32, "log header layout changed");
+
+// Pass a double through the u64 argument word; the format string's {f}
+// placeholder tells the decoder to read it back as a double
+inline uint64_t log_arg(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+inline uint64_t log_arg(uint64_t value) { return value; }
+
+// ======================== ASYNC LOGGER ========================
+
+class AsyncLogger {
+public:
+    explicit AsyncLogger(size_t ring_capacity = 1 << 16)
+        : ring_(ring_capacity) {}
+
+    ~AsyncLogger() { stop(); }
+
+    // Startup only: register a format string and get its id. Placeholders:
+    // {} for an unsigned word, {f} for a double, {x} for hex.
+    uint16_t register_format(const std::string& format) {
+        formats_.push_back(format);
+        return static_cast<uint16_t>(formats_.size() - 1);
+    }
+
+    // Open the sink and start the drain thread; formats are frozen from here
+    void start(const std::string& path) {
+        out_.open(path, std::ios::binary | std::ios::trunc);
+        if (!out_) {
+            throw std::runtime_error("AsyncLogger: cannot open " + path);
+        }
+        write_header();
+        running_.store(true, std::memory_order_release);
+        drain_thread_ = std::thread([this] { drain_loop(); });
+    }
+
+    // Drain whatever is still queued, then close the file
+    void stop() {
+        if (!running_.exchange(false, std::memory_order_acq_rel)) {
+            return;
+        }
+        if (drain_thread_.joinable()) drain_thread_.join();
+        out_.close();
+    }
+
+    // Hot-path calls: one ring push, no formatting, no syscall, never blocks
+    inline void log(uint16_t id) {
+        if (OB_UNLIKELY(!ring_.emplace(LogRecord{id, 0, 0, TscClock::cycles(), {}}))) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    inline void log(uint16_t id, uint64_t a0) {
+        if (OB_UNLIKELY(!ring_.emplace(LogRecord{id, 1, 0, TscClock::cycles(), {a0, 0}}))) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    inline void log(uint16_t id, uint64_t a0, uint64_t a1) {
+        if (OB_UNLIKELY(!ring_.emplace(LogRecord{id, 2, 0, TscClock::cycles(), {a0, a1}}))) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    [[nodiscard]] uint64_t dropped() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+private:
+    void write_header() {
+        LogFileHeader header{LogFileHeader::MAGIC, LogFileHeader::VERSION,
+                             static_cast<uint32_t>(formats_.size()),
+                             TscClock::ns_per_cycle(), TscClock::cycles()};
+        out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const auto& format : formats_) {
+            uint32_t len = static_cast<uint32_t>(format.size());
+            out_.write(reinterpret_cast<const char*>(&len), sizeof(len));
+            out_.write(format.data(), len);
+        }
+    }
+
+    void drain_loop() {
+        LogRecord batch[DRAIN_BATCH];
+        while (running_.load(std::memory_order_acquire) || ring_.size() > 0) {
+            size_t n = ring_.pop_n(batch, DRAIN_BATCH);
+            if (n == 0) {
+                std::this_thread::yield();
+                continue;
+            }
+            // One buffered write per batch; the OS pays for the flush
+            out_.write(reinterpret_cast<const char*>(batch),
+                       static_cast<std::streamsize>(n * sizeof(LogRecord)));
+        }
+        out_.flush();
+    }
+
+    static constexpr size_t DRAIN_BATCH = 512;
+
+    Fifo4<LogRecord> ring_;
+    std::vector<std::string> formats_;
+    std::ofstream out_;
+    std::thread drain_thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> dropped_{0};
+};
+
+// ======================== DECODER ========================
+
+// Offline renderer for binary logs; this is where the formatting cost lives
+class LogDecoder {
+public:
+    // Render every record in `path` to `os`; returns records decoded
+    static uint64_t decode(const std::string& path, std::ostream& os) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("LogDecoder: cannot open " + path);
+        }
+        LogFileHeader header{};
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!in || header.magic != LogFileHeader::MAGIC ||
+            header.version != LogFileHeader::VERSION) {
+            throw std::runtime_error("LogDecoder: bad log file " + path);
+        }
+
+        std::vector<std::string> formats(header.format_count);
+        for (auto& format : formats) {
+            uint32_t len = 0;
+            in.read(reinterpret_cast<char*>(&len), sizeof(len));
+            format.resize(len);
+            in.read(format.data(), len);
+        }
+
+        uint64_t count = 0;
+        LogRecord rec{};
+        while (in.read(reinterpret_cast<char*>(&rec), sizeof(rec))) {
+            uint64_t ns = static_cast<uint64_t>(
+                (rec.tsc - header.base_tsc) * header.ns_per_cycle);
+            os << "[" << std::setw(12) << ns << " ns] ";
+            if (rec.id < formats.size()) {
+                render(os, formats[rec.id], rec);
+            } else {
+                os << "<unknown id " << rec.id << ">";
+            }
+            os << "\n";
+            ++count;
+        }
+        return count;
+    }
+
+private:
+    static void render(std::ostream& os, const std::string& format,
+                       const LogRecord& rec) {
+        size_t arg = 0;
+        for (size_t i = 0; i < format.size(); ++i) {
+            if (format[i] != '{') {
+                os << format[i];
+                continue;
+            }
+            uint64_t word = arg < rec.argc ? rec.args[arg] : 0;
+            ++arg;
+            if (format.compare(i, 3, "{f}") == 0) {
+                double value;
+                std::memcpy(&value, &word, sizeof(value));
+                os << value;
+                i += 2;
+            } else if (format.compare(i, 3, "{x}") == 0) {
+                os << "0x" << std::hex << word << std::dec;
+                i += 2;
+            } else {                      // "{}"
+                os << word;
+                i += 1;
+            }
+        }
+    }
+};
+
+// ======================== MAIN FUNCTION ========================
+
+#ifdef ASYNC_LOG_MAIN
+#include <sstream>
+
+int main(int argc, char** argv) {
+    if (argc > 2 && std::string(argv[1]) == "--decode") {
+        return LogDecoder::decode(argv[2], std::cout) > 0 ? 0 : 1;
+    }
+
+    const std::string path = argc > 1 ? argv[1] : "/tmp/orderbook.blog";
+    const int num_records = argc > 2 ? std::atoi(argv[2]) : 1000000;
+
+    AsyncLogger logger;
+    uint16_t fmt_add    = logger.register_format("add id={} qty={}");
+    uint16_t fmt_cancel = logger.register_format("cancel id={}");
+    uint16_t fmt_bbo    = logger.register_format("bbo bid={f} ask={f}");
+    logger.start(path);
+
+    // Hot-thread cost: log call rate with the drain thread live
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < num_records; ++i) {
+        switch (i % 3) {
+            case 0: logger.log(fmt_add, static_cast<uint64_t>(i), 100 + i % 900); break;
+            case 1: logger.log(fmt_cancel, static_cast<uint64_t>(i)); break;
+            case 2: logger.log(fmt_bbo, log_arg(99.97 + (i % 7) * 0.01),
+                               log_arg(100.02 + (i % 5) * 0.01)); break;
+        }
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    uint64_t dropped = logger.dropped();
+    logger.stop();
+
+    double ns_per_call =
+        std::chrono::duration<double, std::nano>(t1 - t0).count() / num_records;
+    std::cout << "hot thread: " << std::fixed << std::setprecision(1)
+              << ns_per_call << " ns/log call (" << num_records << " records, "
+              << dropped << " dropped)\n";
+
+    // The equivalent of what we replaced, for scale
+    {
+        std::ostringstream sink;
+        auto s0 = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < 100000; ++i) {
+            sink << "add id=" << std::setw(8) << i << " qty="
+                 << std::setw(6) << 100 + i % 900 << "\n";
+        }
+        auto s1 = std::chrono::high_resolution_clock::now();
+        std::cout << "iostream formatting on the calling thread: "
+                  << std::chrono::duration<double, std::nano>(s1 - s0).count() / 100000
+                  << " ns/line (before any syscall)\n";
+    }
+
+    // Round-trip: decode and verify counts and a sample line
+    std::ostringstream text;
+    uint64_t decoded = LogDecoder::decode(path, text);
+    std::string first = text.str().substr(0, text.str().find('\n'));
+    bool ok = decoded + dropped == static_cast<uint64_t>(num_records)
+           && first.find("add id=0 qty=100") != std::string::npos;
+
+    std::cout << "decoder rendered " << decoded << " records; first line:\n  "
+              << first << "\n";
+    std::cout << (ok ? "\nASYNC LOG ROUND-TRIP OK\n" : "\nLOG MISMATCH\n");
+    return ok ? 0 : 1;
+}
+#endif
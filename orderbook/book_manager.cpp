@@ -0,0 +1,123 @@
+// book_manager.hpp - Multi-symbol order book manager with shared pools
+// Compile: g++ -std=c++17 -O3 -march=native -DBOOK_MANAGER_MAIN book_manager.cpp -o book_manager
+//
+// Running ~2,000 symbols as independently heap-allocated OrderBooks wastes a
+// pre-allocated pool block per book and scatters the books across memory.
+// The manager keeps every book in one contiguous vector routed by a dense
+// integer symbol id (array index, no hash lookup on the hot path) and hands
+// all books the same BookPools, so a quiet symbol's freed nodes feed a busy
+// symbol instead of sitting idle.
+
+#pragma once
+#include <string>
+
+#include "orderbook.cpp"
+
+// ======================== MULTI-SYMBOL MANAGER ========================
+
+template<typename StatsPolicy = DefaultStats>
+class BasicOrderBookManager {
+public:
+    using Book = BasicOrderBook<StatsPolicy>;
+    using SymbolId = uint32_t;
+
+    // max_symbols fixes the book array capacity up front so books never
+    // relocate; symbol ids are dense indices into it
+    explicit BasicOrderBookManager(size_t max_symbols = 2048)
+        : max_symbols_(max_symbols) {
+        books_.reserve(max_symbols);
+        symbol_names_.reserve(max_symbols);
+    }
+
+    // Register a symbol and get its dense id; symbol lookup by name is meant
+    // for startup/config paths only, never per message
+    SymbolId add_symbol(const std::string& name, double tick_size = 0.01,
+                        size_t depth_cache = 10) {
+        if (books_.size() >= max_symbols_) {
+            throw std::length_error("OrderBookManager: max_symbols exceeded");
+        }
+        SymbolId id = static_cast<SymbolId>(books_.size());
+        books_.emplace_back(pools_, tick_size, depth_cache);
+        symbol_names_.push_back(name);
+        symbol_ids_.emplace(name, id);
+        return id;
+    }
+
+    [[nodiscard]] SymbolId lookup(const std::string& name) const {
+        return symbol_ids_.at(name);
+    }
+
+    // Hot-path routing: one array index
+    [[nodiscard]] Book& book(SymbolId id) { return books_[id]; }
+    [[nodiscard]] const Book& book(SymbolId id) const { return books_[id]; }
+
+    [[nodiscard]] const std::string& symbol_name(SymbolId id) const {
+        return symbol_names_[id];
+    }
+    [[nodiscard]] size_t symbol_count() const { return books_.size(); }
+
+    // Per-message entry points routed by symbol id
+    void add_order(SymbolId id, const Order& order) {
+        books_[id].add_order(order);
+    }
+    [[nodiscard]] bool cancel_order(SymbolId id, uint64_t order_id) {
+        return books_[id].cancel_order(order_id);
+    }
+    [[nodiscard]] bool amend_order(SymbolId id, uint64_t order_id,
+                                   double new_price, uint64_t new_quantity) {
+        return books_[id].amend_order(order_id, new_price, new_quantity);
+    }
+
+    void print_stats() const {
+        std::cout << "OrderBookManager: " << books_.size() << " symbols\n";
+        pools_.order_pool.print_stats();
+    }
+
+private:
+    size_t max_symbols_;
+    BookPools<StatsPolicy> pools_;      // shared across every book
+    std::vector<Book> books_;           // contiguous, indexed by SymbolId
+    std::vector<std::string> symbol_names_;
+    std::unordered_map<std::string, SymbolId> symbol_ids_;  // startup only
+};
+
+using OrderBookManager = BasicOrderBookManager<>;
+
+// ======================== MAIN FUNCTION ========================
+
+#ifdef BOOK_MANAGER_MAIN
+int main() {
+    OrderBookManager manager(16);
+
+    auto aapl = manager.add_symbol("AAPL", 0.01);
+    auto btc  = manager.add_symbol("BTC-USD", 0.5);
+
+    manager.add_order(aapl, {1, true, 189.55, 100, 0});
+    manager.add_order(aapl, {2, false, 189.60, 200, 0});
+    manager.add_order(btc,  {3, true, 64000.0, 5, 0});
+    manager.add_order(btc,  {4, false, 64000.5, 7, 0});
+
+    for (OrderBookManager::SymbolId id = 0; id < manager.symbol_count(); ++id) {
+        auto [bid, ask] = manager.book(id).get_best_prices();
+        std::cout << manager.symbol_name(id) << ": " << bid << " / " << ask << "\n";
+    }
+
+    if (!manager.cancel_order(aapl, 1)) std::cout << "cancel failed\n";
+    std::cout << "AAPL best bid after cancel: "
+              << manager.book(aapl).get_best_prices().first << "\n";
+
+    // Cross-symbol pooling: nodes freed by one symbol are reused by another
+    for (int i = 0; i < 2000; ++i) {
+        manager.add_order(aapl, {100 + static_cast<uint64_t>(i), true, 189.00, 10, 0});
+    }
+    for (int i = 0; i < 2000; ++i) {
+        (void)manager.cancel_order(aapl, 100 + static_cast<uint64_t>(i));
+    }
+    for (int i = 0; i < 2000; ++i) {
+        manager.add_order(btc, {5000 + static_cast<uint64_t>(i), true, 63999.5, 1, 0});
+    }
+
+    manager.print_stats();
+    return 0;
+}
+#endif
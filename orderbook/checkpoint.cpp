@@ -0,0 +1,238 @@
+// checkpoint.hpp - binary book state image for fast restart
+// Compile: g++ -std=c++17 -O3 -march=native -DCHECKPOINT_MAIN checkpoint.cpp -o checkpoint -pthread
+//
+// Rebuilding a 1M-order book by replaying the day's journal takes minutes;
+// a mid-session restart means missing the market. A checkpoint is the
+// book's state, not its history: every resting order in the canonical
+// serialization order (for_each_resting_order — per side, levels
+// best-first, FIFO within level), written as layout-pinned 40-byte records
+// behind a small header. Restore mmaps the image and hands the record span
+// to OrderBook::restore_sorted in one call: because the records arrive in
+// map order, every level is a hinted O(1) emplace at end() and the tree
+// builds in linear time. Same layout discipline as JournalRecord — pinned
+// offsets, version byte, no pointers in the image.
+
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "orderbook.cpp"
+
+// ======================== IMAGE LAYOUT ========================
+
+struct CheckpointHeader {
+    uint64_t magic;          // "OBCKPT\0\1"
+    uint32_t version;
+    uint32_t reserved;
+    double tick_size;
+    uint64_t order_count;
+    uint64_t capture_ts_ns;  // wall-clock time of the capture
+    uint8_t pad[24];         // header is one 64-byte line
+
+    static constexpr uint64_t MAGIC = 0x0100'54504B43424FULL;  // "OBCKPT\0\1" LE
+    static constexpr uint32_t VERSION = 1;
+};
+static_assert(sizeof(CheckpointHeader) == 64, "checkpoint header layout changed");
+
+struct CheckpointRecord {
+    uint64_t order_id;
+    double price;
+    uint64_t quantity;
+    uint64_t timestamp_ns;
+    uint8_t is_buy;
+    uint8_t reserved[7];
+};
+static_assert(sizeof(CheckpointRecord) == 40, "checkpoint record layout changed");
+static_assert(offsetof(CheckpointRecord, price) == 8, "record layout drift");
+static_assert(offsetof(CheckpointRecord, quantity) == 16, "record layout drift");
+static_assert(offsetof(CheckpointRecord, is_buy) == 32, "record layout drift");
+static_assert(std::is_trivially_copyable_v<CheckpointRecord>,
+              "record must be a plain byte image");
+
+// ======================== SAVE / RESTORE ========================
+
+class BookCheckpoint {
+public:
+    // Serialize the full book state through an mmap'd image: the file is
+    // sized up front, records are stored straight into the mapping (no
+    // write syscalls, no buffering), and msync makes the image durable.
+    template<typename Book>
+    static void save(const Book& book, const std::string& path) {
+        uint64_t count = book.get_stats().active_orders;
+        size_t bytes = sizeof(CheckpointHeader) + count * sizeof(CheckpointRecord);
+
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0 || ::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            if (fd >= 0) ::close(fd);
+            throw std::runtime_error("BookCheckpoint: cannot create " + path);
+        }
+        void* addr = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                            MAP_SHARED, fd, 0);
+        ::close(fd);  // mapping keeps the file alive
+        if (addr == MAP_FAILED) {
+            throw std::runtime_error("BookCheckpoint: mmap failed on " + path);
+        }
+
+        auto* header = static_cast<CheckpointHeader*>(addr);
+        header->magic = CheckpointHeader::MAGIC;
+        header->version = CheckpointHeader::VERSION;
+        header->reserved = 0;
+        header->tick_size = book.to_double(Price{1});
+        header->order_count = count;
+        header->capture_ts_ns = static_cast<uint64_t>(
+            std::chrono::system_clock::now().time_since_epoch().count());
+        std::memset(header->pad, 0, sizeof(header->pad));
+
+        auto* records = reinterpret_cast<CheckpointRecord*>(header + 1);
+        size_t i = 0;
+        book.for_each_resting_order([&](const Order& o) {
+            records[i++] = CheckpointRecord{o.order_id, o.price, o.quantity,
+                                            o.timestamp_ns,
+                                            static_cast<uint8_t>(o.is_buy ? 1 : 0),
+                                            {}};
+        });
+
+        ::msync(addr, bytes, MS_SYNC);
+        ::munmap(addr, bytes);
+    }
+
+    // Restore into an EMPTY book. Returns orders restored.
+    template<typename Book>
+    static size_t restore(Book& book, const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("BookCheckpoint: cannot open " + path);
+        }
+        struct stat st{};
+        ::fstat(fd, &st);
+        size_t bytes = static_cast<size_t>(st.st_size);
+        void* addr = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) {
+            throw std::runtime_error("BookCheckpoint: mmap failed on " + path);
+        }
+        ::madvise(addr, bytes, MADV_SEQUENTIAL);
+
+        const auto* header = static_cast<const CheckpointHeader*>(addr);
+        if (bytes < sizeof(CheckpointHeader) ||
+            header->magic != CheckpointHeader::MAGIC ||
+            header->version != CheckpointHeader::VERSION ||
+            bytes != sizeof(CheckpointHeader) +
+                     header->order_count * sizeof(CheckpointRecord)) {
+            ::munmap(addr, bytes);
+            throw std::runtime_error("BookCheckpoint: bad image " + path);
+        }
+
+        // Records are layout-compatible with Order except for field order;
+        // convert in a reused scratch chunk and bulk-load per chunk (the
+        // chunks preserve global ordering, so the hinted inserts still land
+        // at end())
+        const auto* records = reinterpret_cast<const CheckpointRecord*>(header + 1);
+        std::vector<Order> chunk(16384);
+        size_t restored = 0;
+        while (restored < header->order_count) {
+            size_t n = std::min(chunk.size(), header->order_count - restored);
+            for (size_t i = 0; i < n; ++i) {
+                const CheckpointRecord& r = records[restored + i];
+                chunk[i] = Order{r.order_id, r.is_buy != 0, r.price, r.quantity,
+                                 r.timestamp_ns};
+            }
+            book.restore_sorted(chunk.data(), n);
+            restored += n;
+        }
+        ::munmap(addr, bytes);
+        return restored;
+    }
+};
+
+// ======================== MAIN FUNCTION ========================
+
+#ifdef CHECKPOINT_MAIN
+int main(int argc, char** argv) {
+    const std::string path = argc > 1 ? argv[1] : "/tmp/orderbook.ckpt";
+    const int num_events = argc > 2 ? std::atoi(argv[2]) : 1000000;
+
+    // Build a big live book the usual way
+    OrderBook book;
+    std::mt19937 gen(23);
+    std::normal_distribution<> offset_dist(0.0, 5.0);
+    std::uniform_int_distribution<> quantity_dist(100, 1000);
+    std::uniform_int_distribution<> action_dist(0, 99);
+    double mid = 100.0;
+    uint64_t next_id = 1;
+    std::vector<uint64_t> live;
+    live.reserve(num_events);
+
+    for (int i = 0; i < num_events; ++i) {
+        mid += (gen() % 2 ? 0.01 : -0.01);
+        double px = mid + static_cast<int>(offset_dist(gen)) * 0.01;
+        int action = action_dist(gen);
+        if (action < 60 || live.empty()) {
+            book.add_order({next_id, (gen() % 2) == 0, px,
+                            static_cast<uint64_t>(quantity_dist(gen)), 0});
+            live.push_back(next_id++);
+        } else if (action < 85) {
+            size_t k = gen() % live.size();
+            if (book.cancel_order(live[k])) {
+                live[k] = live.back();
+                live.pop_back();
+            }
+        } else {
+            size_t k = gen() % live.size();
+            (void)book.amend_order(live[k], px,
+                                   static_cast<uint64_t>(quantity_dist(gen)));
+        }
+    }
+    std::cout << "live book: " << book.get_stats().active_orders
+              << " resting orders\n";
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    BookCheckpoint::save(book, path);
+    auto t1 = std::chrono::high_resolution_clock::now();
+
+    OrderBook restored;
+    size_t n = BookCheckpoint::restore(restored, path);
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    auto ms = [](auto a, auto b) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(b - a).count();
+    };
+    std::cout << "checkpoint: save " << ms(t0, t1) << " ms, restore "
+              << ms(t1, t2) << " ms for " << n << " orders\n";
+
+    // Equality check: identical traversal streams means identical levels,
+    // identical FIFO order within levels, identical everything we store
+    std::vector<std::tuple<uint64_t, double, uint64_t>> a, b;
+    book.for_each_resting_order([&](const Order& o) {
+        a.emplace_back(o.order_id, o.price, o.quantity);
+    });
+    restored.for_each_resting_order([&](const Order& o) {
+        b.emplace_back(o.order_id, o.price, o.quantity);
+    });
+    bool ok = a == b && restored.get_stats().active_orders == n;
+
+    // And the restored book must behave: cancel via the lookup, snapshot
+    // via the rebuilt caches
+    ok = ok && restored.cancel_order(live[0]);
+    std::vector<PriceLevel> bids1, asks1, bids2, asks2;
+    (void)book.cancel_order(live[0]);
+    book.get_snapshot(10, bids1, asks1);
+    restored.get_snapshot(10, bids2, asks2);
+    ok = ok && bids1.size() == bids2.size() && asks1.size() == asks2.size();
+    for (size_t i = 0; ok && i < bids1.size(); ++i) {
+        ok = bids1[i].price == bids2[i].price
+             && bids1[i].total_quantity == bids2[i].total_quantity;
+    }
+
+    std::cout << (ok ? "RESTORED BOOK IDENTICAL to live book\n"
+                     : "RESTORE MISMATCH\n");
+    return ok ? 0 : 1;
+}
+#endif
@@ -0,0 +1,306 @@
+// compact_book.hpp - order book with 32-byte nodes and 32-bit pool indices
+// Compile: g++ -std=c++17 -O3 -march=native -DCOMPACT_BOOK_MAIN compact_book.cpp -o compact_book
+//
+// OrderBook's OrderNode carries the full 40-byte Order plus two 64-bit
+// intrusive links plus two tick prices — 72 bytes per resting order. At 1M
+// resident orders that working set is what misses in cache, not the code.
+// CompactOrderBook stores orders in one contiguous slot array and links the
+// per-level FIFO with 32-bit slot indices instead of pointers (index ->
+// pointer is one add off the array base), keeps the tick price in 32 bits,
+// and narrows quantity to uint32_t (fine for our symbology; asserted on
+// ingest). The node is exactly 32 bytes: two resting orders per cache line,
+// half the main book's working set.
+
+#pragma once
+#include <cassert>
+
+#include "orderbook.cpp"
+
+// ======================== COMPACT NODE LAYOUT ========================
+
+inline constexpr uint32_t COMPACT_NIL = 0xFFFFFFFFu;
+
+struct CompactOrderNode {
+    uint64_t order_id;
+    int32_t price_ticks;   // 32-bit tick price: ±2^31 ticks covers any symbol
+    uint32_t quantity;
+    uint32_t prev;         // slot indices into the node array, COMPACT_NIL = none
+    uint32_t next;
+    uint32_t level;        // slot index into the level array
+    uint8_t is_buy;
+    uint8_t pad[3];
+};
+static_assert(sizeof(CompactOrderNode) == 32,
+              "compact node must stay at two orders per cache line");
+
+struct CompactLevel {
+    int32_t price_ticks;
+    uint32_t head;         // oldest order (FIFO front)
+    uint32_t tail;
+    uint32_t order_count;
+    uint64_t total_quantity;
+};
+static_assert(sizeof(CompactLevel) == 24, "level slot layout changed");
+
+// ======================== COMPACT BOOK ========================
+
+class CompactOrderBook {
+public:
+    explicit CompactOrderBook(double tick_size = 0.01, size_t expected_orders = 10000)
+        : tick_size_(tick_size) {
+        nodes_.reserve(expected_orders);
+        node_free_.reserve(expected_orders);
+        levels_.reserve(expected_orders / 8);
+        level_free_.reserve(expected_orders / 8);
+        lookup_.reserve(expected_orders);
+    }
+
+    [[nodiscard]] int32_t to_ticks(double price) const {
+        return static_cast<int32_t>(std::llround(price / tick_size_));
+    }
+    [[nodiscard]] double to_double(int32_t ticks) const {
+        return static_cast<double>(ticks) * tick_size_;
+    }
+
+    void add_order(const Order& order) {
+        assert(order.quantity <= std::numeric_limits<uint32_t>::max());
+
+        uint32_t ni = alloc_node();
+        CompactOrderNode& node = nodes_[ni];
+        node.order_id = order.order_id;
+        node.price_ticks = to_ticks(order.price);
+        node.quantity = static_cast<uint32_t>(order.quantity);
+        node.prev = COMPACT_NIL;
+        node.next = COMPACT_NIL;
+        node.is_buy = order.is_buy ? 1 : 0;
+
+        uint32_t li = order.is_buy ? find_or_make_level(bids_, node.price_ticks)
+                                   : find_or_make_level(asks_, node.price_ticks);
+        node.level = li;
+        link_back(levels_[li], ni);
+        lookup_.emplace(order.order_id, ni);
+    }
+
+    [[nodiscard]] bool cancel_order(uint64_t order_id) {
+        auto it = lookup_.find(order_id);
+        if (it == lookup_.end()) {
+            return false;
+        }
+        uint32_t ni = it->second;
+        unlink_and_maybe_erase_level(ni);
+        lookup_.erase(it);
+        free_node(ni);
+        return true;
+    }
+
+    [[nodiscard]] bool amend_order(uint64_t order_id, double new_price, uint64_t new_quantity) {
+        auto it = lookup_.find(order_id);
+        if (it == lookup_.end()) {
+            return false;
+        }
+        uint32_t ni = it->second;
+        CompactOrderNode& node = nodes_[ni];
+
+        if (node.price_ticks != to_ticks(new_price)) {
+            // Price change: cancel and re-add to keep FIFO fairness
+            Order replacement{order_id, node.is_buy != 0, new_price, new_quantity, 0};
+            (void)cancel_order(order_id);
+            add_order(replacement);
+        } else {
+            assert(new_quantity <= std::numeric_limits<uint32_t>::max());
+            CompactLevel& level = levels_[node.level];
+            level.total_quantity = level.total_quantity - node.quantity
+                                 + static_cast<uint32_t>(new_quantity);
+            node.quantity = static_cast<uint32_t>(new_quantity);
+        }
+        return true;
+    }
+
+    [[nodiscard]] std::pair<double, double> get_best_prices() const {
+        double bid = bids_.empty() ? 0.0 : to_double(bids_.begin()->first);
+        double ask = asks_.empty() ? std::numeric_limits<double>::max()
+                                   : to_double(asks_.begin()->first);
+        return {bid, ask};
+    }
+
+    // Same shape as OrderBook::get_snapshot so the two books can be diffed
+    void get_snapshot(size_t depth, std::vector<PriceLevel>& bids,
+                      std::vector<PriceLevel>& asks) const {
+        bids.clear();
+        asks.clear();
+        bids.reserve(depth);
+        asks.reserve(depth);
+        size_t count = 0;
+        for (const auto& [ticks, li] : bids_) {
+            if (count++ >= depth) break;
+            bids.push_back(PriceLevel{Price{ticks}, levels_[li].total_quantity});
+        }
+        count = 0;
+        for (const auto& [ticks, li] : asks_) {
+            if (count++ >= depth) break;
+            asks.push_back(PriceLevel{Price{ticks}, levels_[li].total_quantity});
+        }
+    }
+
+    [[nodiscard]] size_t active_orders() const { return lookup_.size(); }
+
+    // Bytes of node storage per resting order, the number this layout exists
+    // to halve
+    [[nodiscard]] size_t node_bytes() const {
+        return nodes_.capacity() * sizeof(CompactOrderNode);
+    }
+
+private:
+    // Slot pools in MemoryPool style: contiguous arrays plus index free lists
+    uint32_t alloc_node() {
+        if (!node_free_.empty()) {
+            uint32_t i = node_free_.back();
+            node_free_.pop_back();
+            return i;
+        }
+        nodes_.emplace_back();
+        return static_cast<uint32_t>(nodes_.size() - 1);
+    }
+    void free_node(uint32_t i) { node_free_.push_back(i); }
+
+    uint32_t alloc_level() {
+        if (!level_free_.empty()) {
+            uint32_t i = level_free_.back();
+            level_free_.pop_back();
+            return i;
+        }
+        levels_.emplace_back();
+        return static_cast<uint32_t>(levels_.size() - 1);
+    }
+    void free_level(uint32_t i) { level_free_.push_back(i); }
+
+    template<typename MapType>
+    uint32_t find_or_make_level(MapType& side, int32_t ticks) {
+        auto it = side.find(ticks);
+        if (it != side.end()) {
+            return it->second;
+        }
+        uint32_t li = alloc_level();
+        CompactLevel& level = levels_[li];
+        level.price_ticks = ticks;
+        level.head = COMPACT_NIL;
+        level.tail = COMPACT_NIL;
+        level.order_count = 0;
+        level.total_quantity = 0;
+        side.emplace(ticks, li);
+        return li;
+    }
+
+    void link_back(CompactLevel& level, uint32_t ni) {
+        CompactOrderNode& node = nodes_[ni];
+        node.prev = level.tail;
+        node.next = COMPACT_NIL;
+        if (level.tail != COMPACT_NIL) {
+            nodes_[level.tail].next = ni;
+        } else {
+            level.head = ni;
+        }
+        level.tail = ni;
+        level.total_quantity += node.quantity;
+        ++level.order_count;
+    }
+
+    void unlink_and_maybe_erase_level(uint32_t ni) {
+        CompactOrderNode& node = nodes_[ni];
+        CompactLevel& level = levels_[node.level];
+
+        if (node.prev != COMPACT_NIL) {
+            nodes_[node.prev].next = node.next;
+        } else {
+            level.head = node.next;
+        }
+        if (node.next != COMPACT_NIL) {
+            nodes_[node.next].prev = node.prev;
+        } else {
+            level.tail = node.prev;
+        }
+        level.total_quantity -= node.quantity;
+        --level.order_count;
+
+        if (level.head == COMPACT_NIL) {
+            if (node.is_buy) {
+                bids_.erase(level.price_ticks);
+            } else {
+                asks_.erase(level.price_ticks);
+            }
+            free_level(node.level);
+        }
+    }
+
+    double tick_size_;
+    std::vector<CompactOrderNode> nodes_;
+    std::vector<uint32_t> node_free_;
+    std::vector<CompactLevel> levels_;
+    std::vector<uint32_t> level_free_;
+    std::map<int32_t, uint32_t, std::greater<int32_t>> bids_;
+    std::map<int32_t, uint32_t, std::less<int32_t>> asks_;
+    std::unordered_map<uint64_t, uint32_t> lookup_;
+};
+
+// ======================== MAIN FUNCTION ========================
+
+#ifdef COMPACT_BOOK_MAIN
+int main() {
+    std::cout << "node sizes: OrderNode " << sizeof(OrderNode)
+              << " B, CompactOrderNode " << sizeof(CompactOrderNode) << " B\n";
+
+    // Drive both books through an identical randomized flow and diff them
+    OrderBook reference;
+    CompactOrderBook compact;
+
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<> px(99.0, 101.0);
+    std::uniform_int_distribution<> qd(1, 500);
+    std::uniform_int_distribution<> action(0, 99);
+    std::vector<uint64_t> live;
+    uint64_t id = 1;
+
+    for (int i = 0; i < 200000; ++i) {
+        int a = action(gen);
+        if (a < 55 || live.empty()) {
+            Order o{id, (gen() % 2) == 0, px(gen), static_cast<uint64_t>(qd(gen)), 0};
+            reference.add_order(o);
+            compact.add_order(o);
+            live.push_back(id++);
+        } else if (a < 85) {
+            size_t k = gen() % live.size();
+            bool r1 = reference.cancel_order(live[k]);
+            bool r2 = compact.cancel_order(live[k]);
+            assert(r1 == r2);
+            live[k] = live.back();
+            live.pop_back();
+        } else {
+            size_t k = gen() % live.size();
+            double p = px(gen);
+            uint64_t q = static_cast<uint64_t>(qd(gen));
+            (void)reference.amend_order(live[k], p, q);
+            (void)compact.amend_order(live[k], p, q);
+        }
+    }
+
+    std::vector<PriceLevel> rb, ra, cb, ca;
+    reference.get_snapshot(25, rb, ra);
+    compact.get_snapshot(25, cb, ca);
+    bool ok = rb.size() == cb.size() && ra.size() == ca.size()
+              && reference.get_stats().active_orders == compact.active_orders();
+    for (size_t i = 0; ok && i < rb.size(); ++i) {
+        ok = rb[i].price == cb[i].price && rb[i].total_quantity == cb[i].total_quantity;
+    }
+    for (size_t i = 0; ok && i < ra.size(); ++i) {
+        ok = ra[i].price == ca[i].price && ra[i].total_quantity == ca[i].total_quantity;
+    }
+    std::cout << (ok ? "COMPACT BOOK CONSISTENT with reference\n"
+                     : "COMPACT BOOK MISMATCH\n");
+
+    std::cout << "resident orders: " << compact.active_orders()
+              << ", node storage " << compact.node_bytes() / 1024 << " KB compact vs ~"
+              << compact.active_orders() * sizeof(OrderNode) / 1024
+              << " KB pointer-based\n";
+    return ok ? 0 : 1;
+}
+#endif
@@ -0,0 +1,248 @@
+// depth_analytics.hpp - SIMD analytics over a structure-of-arrays depth band
+// Compile: g++ -std=c++17 -O3 -march=native -DDEPTH_ANALYTICS_MAIN depth_analytics.cpp -o depth_analytics
+//
+// Signal code (imbalance, weighted mid, cumulative depth) recomputes sums
+// over the top levels on every tick. PriceLevel is an array-of-structs, so
+// those loops stride over interleaved price/quantity pairs and never
+// vectorize cleanly. DepthBand repacks the top-N levels into separate
+// price[] / quantity[] arrays once per snapshot; the kernels then run over
+// contiguous doubles, with AVX2 paths where the compiler targets them and a
+// scalar fallback that the auto-vectorizer still handles well.
+
+#pragma once
+#include "orderbook.cpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// ======================== SOA DEPTH BAND ========================
+
+// One side's top-N levels as parallel arrays, 32-byte aligned for aligned
+// vector loads. BAND_CAPACITY covers any realistic signal depth.
+struct DepthBand {
+    static constexpr size_t BAND_CAPACITY = 32;
+
+    alignas(32) double price[BAND_CAPACITY];
+    alignas(32) double quantity[BAND_CAPACITY];
+    size_t depth = 0;
+
+    // Repack a snapshot side into the band (prices converted to doubles once
+    // here instead of inside every kernel)
+    template<typename Book>
+    void load(const Book& book, const std::vector<PriceLevel>& side) {
+        depth = std::min(side.size(), BAND_CAPACITY);
+        for (size_t i = 0; i < depth; ++i) {
+            price[i] = book.to_double(side[i].price);
+            quantity[i] = static_cast<double>(side[i].total_quantity);
+        }
+        // Zero the tail so full-width vector ops never read garbage
+        for (size_t i = depth; i < BAND_CAPACITY; ++i) {
+            price[i] = 0.0;
+            quantity[i] = 0.0;
+        }
+    }
+};
+
+// ======================== KERNELS ========================
+
+namespace depth_kernels {
+
+// Sum of the first n entries
+inline double sum(const double* values, size_t n) {
+#if defined(__AVX2__)
+    __m256d acc = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = _mm256_add_pd(acc, _mm256_loadu_pd(values + i));
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, acc);
+    double total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i < n; ++i) {
+        total += values[i];
+    }
+    return total;
+#else
+    double total = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        total += values[i];
+    }
+    return total;
+#endif
+}
+
+// Dot product of the first n price/quantity pairs (notional value)
+inline double dot(const double* a, const double* b, size_t n) {
+#if defined(__AVX2__) && defined(__FMA__)
+    __m256d acc = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), acc);
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, acc);
+    double total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i < n; ++i) {
+        total += a[i] * b[i];
+    }
+    return total;
+#else
+    double total = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        total += a[i] * b[i];
+    }
+    return total;
+#endif
+}
+
+// Running prefix sum of quantities: out[i] = sum(values[0..i]).
+// Prefix sums carry a loop dependency, so the vector win comes from the
+// in-register shift trick rather than plain lane-parallel adds.
+inline void cumulative(const double* values, size_t n, double* out) {
+#if defined(__AVX2__)
+    __m256d carry = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_loadu_pd(values + i);
+        // In-lane prefix: x += shift_left_by_one, then by two
+        __m256d t = _mm256_permute4x64_pd(x, _MM_SHUFFLE(2, 1, 0, 3));
+        t = _mm256_blend_pd(t, _mm256_setzero_pd(), 0x1);
+        x = _mm256_add_pd(x, t);
+        t = _mm256_permute4x64_pd(x, _MM_SHUFFLE(1, 0, 3, 2));
+        t = _mm256_blend_pd(t, _mm256_setzero_pd(), 0x3);
+        x = _mm256_add_pd(x, t);
+        x = _mm256_add_pd(x, carry);
+        _mm256_storeu_pd(out + i, x);
+        // Broadcast the block total into every lane for the next block
+        carry = _mm256_permute4x64_pd(x, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    double running = (i > 0) ? out[i - 1] : 0.0;
+    for (; i < n; ++i) {
+        running += values[i];
+        out[i] = running;
+    }
+#else
+    double running = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        running += values[i];
+        out[i] = running;
+    }
+#endif
+}
+
+}  // namespace depth_kernels
+
+// ======================== ANALYTICS ========================
+
+// Snapshot-derived signals over both bands. Load once per book update, then
+// each signal is a couple of vector reductions with no book access.
+class DepthAnalytics {
+public:
+    template<typename Book>
+    void load(const Book& book, size_t depth = DepthBand::BAND_CAPACITY) {
+        book.get_snapshot(depth, scratch_bids_, scratch_asks_);
+        bids_.load(book, scratch_bids_);
+        asks_.load(book, scratch_asks_);
+    }
+
+    // Quantity-weighted mid across the loaded band; falls back to 0 when
+    // either side is empty
+    [[nodiscard]] double weighted_mid() const {
+        double bid_qty = depth_kernels::sum(bids_.quantity, bids_.depth);
+        double ask_qty = depth_kernels::sum(asks_.quantity, asks_.depth);
+        if (bid_qty == 0.0 || ask_qty == 0.0) return 0.0;
+        double bid_vwap = depth_kernels::dot(bids_.price, bids_.quantity, bids_.depth) / bid_qty;
+        double ask_vwap = depth_kernels::dot(asks_.price, asks_.quantity, asks_.depth) / ask_qty;
+        return (bid_vwap * ask_qty + ask_vwap * bid_qty) / (bid_qty + ask_qty);
+    }
+
+    // (bid volume - ask volume) / (bid volume + ask volume), in [-1, 1]
+    [[nodiscard]] double imbalance() const {
+        double bid_qty = depth_kernels::sum(bids_.quantity, bids_.depth);
+        double ask_qty = depth_kernels::sum(asks_.quantity, asks_.depth);
+        double total = bid_qty + ask_qty;
+        return total == 0.0 ? 0.0 : (bid_qty - ask_qty) / total;
+    }
+
+    // Cumulative quantity ladders (out arrays must hold BAND_CAPACITY)
+    void cumulative_bid_depth(double* out) const {
+        depth_kernels::cumulative(bids_.quantity, bids_.depth, out);
+    }
+    void cumulative_ask_depth(double* out) const {
+        depth_kernels::cumulative(asks_.quantity, asks_.depth, out);
+    }
+
+    [[nodiscard]] const DepthBand& bids() const { return bids_; }
+    [[nodiscard]] const DepthBand& asks() const { return asks_; }
+
+private:
+    DepthBand bids_;
+    DepthBand asks_;
+    mutable std::vector<PriceLevel> scratch_bids_;
+    mutable std::vector<PriceLevel> scratch_asks_;
+};
+
+// ======================== MAIN FUNCTION ========================
+
+#ifdef DEPTH_ANALYTICS_MAIN
+int main() {
+    OrderBook book;
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<> qd(100, 1000);
+
+    uint64_t id = 1;
+    for (int lvl = 0; lvl < 20; ++lvl) {
+        for (int k = 0; k < 3; ++k) {
+            book.add_order({id++, true, 100.00 - lvl * 0.01, static_cast<uint64_t>(qd(gen)), 0});
+            book.add_order({id++, false, 100.01 + lvl * 0.01, static_cast<uint64_t>(qd(gen)), 0});
+        }
+    }
+
+    DepthAnalytics analytics;
+    analytics.load(book, 10);
+
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "weighted mid: " << analytics.weighted_mid() << "\n";
+    std::cout << "imbalance:    " << analytics.imbalance() << "\n";
+
+    double cum[DepthBand::BAND_CAPACITY];
+    analytics.cumulative_bid_depth(cum);
+    std::cout << "cumulative bid depth:";
+    for (size_t i = 0; i < analytics.bids().depth; ++i) {
+        std::cout << " " << std::setprecision(0) << cum[i];
+    }
+    std::cout << "\n";
+
+    // Cross-check the kernels against plain scalar sums
+    {
+        const DepthBand& b = analytics.bids();
+        double s = 0;
+        for (size_t i = 0; i < b.depth; ++i) s += b.quantity[i];
+        double ks = depth_kernels::sum(b.quantity, b.depth);
+        double run = 0;
+        bool cum_ok = true;
+        for (size_t i = 0; i < b.depth; ++i) {
+            run += b.quantity[i];
+            if (std::abs(run - cum[i]) > 1e-9) cum_ok = false;
+        }
+        std::cout << "kernel check: sum " << (std::abs(s - ks) < 1e-9 ? "OK" : "FAIL")
+                  << ", cumulative " << (cum_ok ? "OK" : "FAIL") << "\n";
+    }
+
+    // Throughput: signals per second including the snapshot + repack
+    const int iters = 200000;
+    double sink = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iters; ++i) {
+        analytics.load(book, 10);
+        sink += analytics.weighted_mid() + analytics.imbalance();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    std::cout << std::setprecision(0)
+              << "load+signals: " << (iters * 1000000.0) / micros << " per sec"
+              << " (sink " << std::setprecision(2) << sink / iters << ")\n";
+    return 0;
+}
+#endif
@@ -0,0 +1,336 @@
+// feed_decoder.cpp - compile-time-dispatched multi-message feed decoder
+// Compile: g++ -std=c++17 -O3 -march=native -DFEED_DECODER_MAIN feed_decoder.cpp -o feed_decoder -pthread
+//
+// MarketFeed.cpp casts whole datagrams to one fixed MarketData layout; a
+// real feed interleaves adds, cancels, amends, trades and heartbeats with
+// different sizes. The usual decoder shape — runtime switch on type, then a
+// call through a handler interface — pays a mispredicted branch plus an
+// indirect call per message. Here the message set is a compile-time type
+// list (the L9 metaprogramming toolkit applied to something hotter than
+// Fibonacci): each wire struct carries its TYPE constant, a dense dispatch
+// table indexed by the type byte is generated from the list at compile
+// time, and the per-type decode thunks are stamped out as templates so the
+// handler body inlines into each thunk. Adding a message type is one struct
+// plus one entry in the list; the table, framing and dispatch regenerate
+// themselves.
+
+#pragma once
+#include <array>
+#include <cstring>
+
+#include "orderbook.cpp"
+
+// ======================== WIRE MESSAGE SET ========================
+
+// Common frame header; length makes unknown message types skippable, so old
+// decoders survive feed upgrades
+struct WireHeader {
+    uint8_t type;
+    uint8_t flags;
+    uint16_t length;     // total frame length including this header
+    uint32_t seq;
+};
+static_assert(sizeof(WireHeader) == 8, "wire header layout changed");
+
+struct WireAdd {
+    WireHeader header;
+    uint64_t order_id;
+    double price;
+    uint64_t quantity;
+    uint8_t is_buy;
+    uint8_t reserved[7];
+
+    static constexpr uint8_t TYPE = 1;
+};
+static_assert(sizeof(WireAdd) == 40, "wire add layout changed");
+
+struct WireCancel {
+    WireHeader header;
+    uint64_t order_id;
+
+    static constexpr uint8_t TYPE = 2;
+};
+static_assert(sizeof(WireCancel) == 16, "wire cancel layout changed");
+
+struct WireAmendMsg {
+    WireHeader header;
+    uint64_t order_id;
+    double price;
+    uint64_t quantity;
+
+    static constexpr uint8_t TYPE = 3;
+};
+static_assert(sizeof(WireAmendMsg) == 32, "wire amend layout changed");
+
+struct WireTrade {
+    WireHeader header;
+    uint64_t maker_order_id;
+    uint64_t taker_order_id;
+    double price;
+    uint64_t quantity;
+
+    static constexpr uint8_t TYPE = 4;
+};
+static_assert(sizeof(WireTrade) == 40, "wire trade layout changed");
+
+struct WireHeartbeat {
+    WireHeader header;
+    uint64_t timestamp_ns;
+
+    static constexpr uint8_t TYPE = 5;
+};
+static_assert(sizeof(WireHeartbeat) == 16, "wire heartbeat layout changed");
+
+// ======================== COMPILE-TIME MESSAGE LIST ========================
+
+template<typename... Messages>
+struct MessageList {
+    static constexpr size_t count = sizeof...(Messages);
+};
+
+// The production feed's message set; the decoder below is generated from it
+using FeedMessages = MessageList<WireAdd, WireCancel, WireAmendMsg,
+                                 WireTrade, WireHeartbeat>;
+
+// ======================== DECODER ========================
+
+template<typename Handler, typename List>
+class FeedDecoder;
+
+template<typename Handler, typename... Messages>
+class FeedDecoder<Handler, MessageList<Messages...>> {
+public:
+    explicit FeedDecoder(Handler& handler) : handler_(handler) {}
+
+    // Walk a buffer of framed messages, dispatching each through the dense
+    // table. Returns the number of bytes consumed; a truncated trailing
+    // frame is left for the caller to complete (stream reassembly).
+    size_t decode(const unsigned char* data, size_t len) {
+        size_t offset = 0;
+        while (offset + sizeof(WireHeader) <= len) {
+            WireHeader header;
+            std::memcpy(&header, data + offset, sizeof(header));
+            if (header.length < sizeof(WireHeader) ||
+                offset + header.length > len) {
+                break;   // partial frame: wait for the rest
+            }
+            Thunk thunk = table_[header.type];
+            if (OB_LIKELY(thunk != nullptr)) {
+                thunk(handler_, data + offset);
+                ++decoded_;
+            } else {
+                ++unknown_;   // skippable: the length field frames it anyway
+            }
+            offset += header.length;
+        }
+        return offset;
+    }
+
+    [[nodiscard]] uint64_t decoded() const { return decoded_; }
+    [[nodiscard]] uint64_t unknown() const { return unknown_; }
+
+private:
+    using Thunk = void (*)(Handler&, const unsigned char*);
+
+    // One thunk stamped out per message type; the handler overload inlines
+    // into it, so the only indirection left is the table load itself
+    template<typename M>
+    static void decode_one(Handler& handler, const unsigned char* bytes) {
+        M msg;
+        std::memcpy(&msg, bytes, sizeof(M));  // alignment-safe, elided at -O3
+        handler.on(msg);
+    }
+
+    // Dense table generated from the type list at compile time
+    static constexpr size_t TABLE_SIZE = 256;
+
+    static constexpr std::array<Thunk, TABLE_SIZE> make_table() {
+        std::array<Thunk, TABLE_SIZE> table{};
+        ((table[Messages::TYPE] = &decode_one<Messages>), ...);
+        return table;
+    }
+    static constexpr std::array<Thunk, TABLE_SIZE> table_ = make_table();
+
+    static_assert(((Messages::TYPE < TABLE_SIZE) && ...),
+                  "message TYPE must fit the dispatch table");
+    static_assert(((sizeof(Messages) >= sizeof(WireHeader)) && ...),
+                  "every message embeds the wire header");
+
+    Handler& handler_;
+    uint64_t decoded_ = 0;
+    uint64_t unknown_ = 0;
+};
+
+// ======================== BOOK HANDLER ========================
+
+// Turns decoded messages into BookUpdate batches for apply_batch(); the
+// pipeline's consumer thread would drain these spans into the book
+template<typename Book>
+struct BookFeedHandler {
+    explicit BookFeedHandler(Book& book) : book_(book) {}
+
+    inline void on(const WireAdd& m) {
+        push({BookUpdate::Op::Add,
+              Order{m.order_id, m.is_buy != 0, m.price, m.quantity, 0}});
+    }
+    inline void on(const WireCancel& m) {
+        push({BookUpdate::Op::Cancel, Order{m.order_id, false, 0.0, 0, 0}});
+    }
+    inline void on(const WireAmendMsg& m) {
+        push({BookUpdate::Op::Amend,
+              Order{m.order_id, false, m.price, m.quantity, 0}});
+    }
+    inline void on(const WireTrade&) { ++trades_; }
+    inline void on(const WireHeartbeat&) { ++heartbeats_; }
+
+    void flush() {
+        if (!batch_.empty()) {
+            applied_ += book_.apply_batch(batch_.data(), batch_.size());
+            batch_.clear();
+        }
+    }
+
+    [[nodiscard]] uint64_t applied() const { return applied_; }
+    [[nodiscard]] uint64_t trades() const { return trades_; }
+    [[nodiscard]] uint64_t heartbeats() const { return heartbeats_; }
+
+private:
+    static constexpr size_t BATCH = 256;
+
+    inline void push(BookUpdate update) {
+        batch_.push_back(update);
+        if (batch_.size() >= BATCH) flush();
+    }
+
+    Book& book_;
+    std::vector<BookUpdate> batch_;
+    uint64_t applied_ = 0;
+    uint64_t trades_ = 0;
+    uint64_t heartbeats_ = 0;
+};
+
+// ======================== MAIN FUNCTION ========================
+
+#ifdef FEED_DECODER_MAIN
+
+// A counting handler for verification and for the dispatch benchmark
+struct CountingHandler {
+    uint64_t adds = 0, cancels = 0, amends = 0, trades = 0, heartbeats = 0;
+    uint64_t checksum = 0;
+    inline void on(const WireAdd& m) { ++adds; checksum += m.order_id; }
+    inline void on(const WireCancel& m) { ++cancels; checksum += m.order_id; }
+    inline void on(const WireAmendMsg& m) { ++amends; checksum += m.order_id; }
+    inline void on(const WireTrade& m) { ++trades; checksum += m.quantity; }
+    inline void on(const WireHeartbeat&) { ++heartbeats; }
+};
+
+template<typename M>
+static void append(std::vector<unsigned char>& wire, M msg, uint32_t seq) {
+    msg.header = WireHeader{M::TYPE, 0, static_cast<uint16_t>(sizeof(M)), seq};
+    const auto* p = reinterpret_cast<const unsigned char*>(&msg);
+    wire.insert(wire.end(), p, p + sizeof(M));
+}
+
+int main(int argc, char** argv) {
+    const int num_messages = argc > 1 ? std::atoi(argv[1]) : 1000000;
+
+    // Build an interleaved wire stream with realistic type mix
+    std::mt19937 gen(17);
+    std::uniform_real_distribution<> price_dist(90.0, 110.0);
+    std::uniform_int_distribution<> quantity_dist(100, 1000);
+    std::uniform_int_distribution<> mix_dist(0, 99);
+
+    std::vector<unsigned char> wire;
+    wire.reserve(static_cast<size_t>(num_messages) * sizeof(WireAdd));
+    uint64_t expect[6] = {};   // counts by TYPE
+    uint64_t next_id = 1;
+    for (int i = 0; i < num_messages; ++i) {
+        int mix = mix_dist(gen);
+        uint32_t seq = static_cast<uint32_t>(i);
+        if (mix < 55 || next_id < 100) {
+            WireAdd m{};
+            m.order_id = next_id++;
+            m.price = price_dist(gen);
+            m.quantity = static_cast<uint64_t>(quantity_dist(gen));
+            m.is_buy = (gen() % 2) == 0 ? 1 : 0;
+            append(wire, m, seq);
+            ++expect[WireAdd::TYPE];
+        } else if (mix < 75) {
+            WireCancel m{};
+            m.order_id = 1 + gen() % (next_id - 1);
+            append(wire, m, seq);
+            ++expect[WireCancel::TYPE];
+        } else if (mix < 90) {
+            WireAmendMsg m{};
+            m.order_id = 1 + gen() % (next_id - 1);
+            m.price = price_dist(gen);
+            m.quantity = static_cast<uint64_t>(quantity_dist(gen));
+            append(wire, m, seq);
+            ++expect[WireAmendMsg::TYPE];
+        } else if (mix < 97) {
+            WireTrade m{};
+            m.maker_order_id = 1 + gen() % (next_id - 1);
+            m.taker_order_id = next_id + 1000000;
+            m.price = price_dist(gen);
+            m.quantity = static_cast<uint64_t>(quantity_dist(gen));
+            append(wire, m, seq);
+            ++expect[WireTrade::TYPE];
+        } else {
+            WireHeartbeat m{};
+            m.timestamp_ns = static_cast<uint64_t>(i);
+            append(wire, m, seq);
+            ++expect[WireHeartbeat::TYPE];
+        }
+    }
+
+    // Correctness: every frame dispatched to the right handler overload
+    CountingHandler counter;
+    FeedDecoder<CountingHandler, FeedMessages> decoder(counter);
+    size_t consumed = decoder.decode(wire.data(), wire.size());
+
+    bool ok = consumed == wire.size()
+           && counter.adds == expect[WireAdd::TYPE]
+           && counter.cancels == expect[WireCancel::TYPE]
+           && counter.amends == expect[WireAmendMsg::TYPE]
+           && counter.trades == expect[WireTrade::TYPE]
+           && counter.heartbeats == expect[WireHeartbeat::TYPE]
+           && decoder.unknown() == 0;
+
+    std::cout << "decoded " << decoder.decoded() << " frames ("
+              << counter.adds << " adds, " << counter.cancels << " cancels, "
+              << counter.amends << " amends, " << counter.trades << " trades, "
+              << counter.heartbeats << " heartbeats)\n";
+
+    // Partial-frame handling: split the stream at an awkward byte boundary
+    {
+        CountingHandler c2;
+        FeedDecoder<CountingHandler, FeedMessages> d2(c2);
+        size_t cut = wire.size() / 2 - 3;
+        size_t used = d2.decode(wire.data(), cut);
+        std::vector<unsigned char> rest(wire.begin() + used, wire.end());
+        used += d2.decode(rest.data(), rest.size());
+        ok = ok && used == wire.size() && d2.decoded() == decoder.decoded()
+                && c2.checksum == counter.checksum;
+        std::cout << "resumed decode across a split frame: "
+                  << (d2.decoded() == decoder.decoded() ? "intact" : "BROKEN")
+                  << "\n";
+    }
+
+    // Throughput: table dispatch end to end into a real book
+    OrderBook book;
+    BookFeedHandler<OrderBook> book_handler(book);
+    FeedDecoder<BookFeedHandler<OrderBook>, FeedMessages> book_decoder(book_handler);
+    auto t0 = std::chrono::high_resolution_clock::now();
+    book_decoder.decode(wire.data(), wire.size());
+    book_handler.flush();
+    auto t1 = std::chrono::high_resolution_clock::now();
+    double secs = std::chrono::duration<double>(t1 - t0).count();
+
+    std::cout << "wire->book: " << book_handler.applied() << " events applied, "
+              << book.get_stats().active_orders << " resting, "
+              << static_cast<uint64_t>(num_messages / secs) << " msgs/sec\n";
+
+    std::cout << (ok ? "\nDECODER DISPATCH CORRECT\n" : "\nDECODER MISMATCH\n");
+    return ok ? 0 : 1;
+}
+#endif
@@ -0,0 +1,176 @@
+// feed_pipeline.cpp - Two-thread feed -> book pipeline over Fifo3
+// Compile: g++ -std=c++17 -O3 -march=native feed_pipeline.cpp -o feed_pipeline -pthread
+//
+// Producer thread decodes feed messages into fixed OrderMessage structs and
+// pushes them through the SPSC Fifo3; consumer thread drains into the
+// OrderBook. Both threads are pinned to their own cores, matching the
+// production layout where the socket reader and the book never share a core.
+// Every message carries a TSC stamp from the producer, and the consumer
+// records the wire-to-book span into a SpanCollector (timing.cpp), so the
+// report shows queue-latency percentiles rather than a mean that hides the
+// tail.
+
+#include <pthread.h>
+#include <thread>
+
+#include "orderbook.cpp"
+#include "../SPSC_QUEUES/spsc_q3.cpp"
+
+// ======================== PIPELINE MESSAGE FORMAT ========================
+
+// Fixed-size message pushed through the queue; one per feed event
+struct OrderMessage {
+    enum class Type : uint8_t { Add, Cancel, Amend };
+
+    Type type;
+    Order order;             // Fully populated for Add; id/price/qty for Amend
+    uint64_t enqueue_cycles; // Producer TSC stamp for queue-latency attribution
+};
+
+// ======================== CORE AFFINITY ========================
+
+// Pin the calling thread to one core; returns false if the request failed
+// (e.g. fewer cores than requested), in which case the pipeline still runs.
+inline bool pin_to_core(int core) {
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(core, &cpuset);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset) == 0;
+}
+
+// ======================== PIPELINE ========================
+
+class FeedPipeline {
+public:
+    FeedPipeline(size_t queue_capacity, int producer_core, int consumer_core)
+        : queue_(queue_capacity),
+          producer_core_(producer_core),
+          consumer_core_(consumer_core) {
+        collector_.set_tag_name(TAG_QUEUE, "wire->book");
+    }
+
+    // Run num_messages synthetic feed events through the pipeline and report
+    void run(int num_messages) {
+        std::thread producer([this, num_messages] { produce(num_messages); });
+        std::thread consumer([this, num_messages] { consume(num_messages); });
+
+        producer.join();
+        consumer.join();
+        report(num_messages);
+    }
+
+private:
+    void produce(int num_messages) {
+        if (!pin_to_core(producer_core_)) {
+            std::cout << "⚠️  Could not pin producer to core " << producer_core_ << "\n";
+        }
+
+        // Synthetic decode: same distributions as the OrderBook tester
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<> price_dist(90.0, 110.0);
+        std::uniform_int_distribution<> quantity_dist(100, 1000);
+        std::uniform_int_distribution<> side_dist(0, 1);
+        std::uniform_int_distribution<> action_dist(0, 9);
+
+        for (int i = 0; i < num_messages; ++i) {
+            OrderMessage msg;
+            int action = action_dist(gen);
+            if (i > 1000 && action == 0) {
+                msg.type = OrderMessage::Type::Cancel;
+                msg.order.order_id = static_cast<uint64_t>(i - 1000);
+            } else if (i > 1000 && action == 1) {
+                msg.type = OrderMessage::Type::Amend;
+                msg.order.order_id = static_cast<uint64_t>(i - 500);
+                msg.order.price = price_dist(gen);
+                msg.order.quantity = static_cast<uint64_t>(quantity_dist(gen));
+            } else {
+                msg.type = OrderMessage::Type::Add;
+                msg.order = Order{
+                    static_cast<uint64_t>(i),
+                    side_dist(gen) == 0,
+                    price_dist(gen),
+                    static_cast<uint64_t>(quantity_dist(gen)),
+                    0
+                };
+            }
+
+            msg.enqueue_cycles = TscClock::cycles();
+            while (!queue_.push(msg)) {
+                // Queue full: spin until the consumer catches up
+            }
+        }
+    }
+
+    void consume(int num_messages) {
+        if (!pin_to_core(consumer_core_)) {
+            std::cout << "⚠️  Could not pin consumer to core " << consumer_core_ << "\n";
+        }
+
+        start_ns_ = TscClock::now_ns();
+        OrderMessage msg;
+        for (int i = 0; i < num_messages; ++i) {
+            while (!queue_.pop(msg)) {
+                // Queue empty: spin until the producer publishes
+            }
+
+            // Wire-to-book attribution: every message, not a sample
+            collector_.record(TAG_QUEUE, msg.enqueue_cycles, TscClock::cycles());
+
+            switch (msg.type) {
+                case OrderMessage::Type::Add:
+                    book_.add_order(msg.order);
+                    break;
+                case OrderMessage::Type::Cancel:
+                    (void)book_.cancel_order(msg.order.order_id);
+                    break;
+                case OrderMessage::Type::Amend:
+                    (void)book_.amend_order(msg.order.order_id, msg.order.price, msg.order.quantity);
+                    break;
+            }
+        }
+        end_ns_ = TscClock::now_ns();
+    }
+
+    void report(int num_messages) {
+        double elapsed_us = (end_ns_ - start_ns_) / 1000.0;
+
+        std::cout << "\n╔════════════════════════════════╗\n";
+        std::cout << "║     FEED PIPELINE REPORT        ║\n";
+        std::cout << "╚════════════════════════════════╝\n";
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "  • Messages: " << num_messages << "\n";
+        std::cout << "  • Elapsed: " << elapsed_us << " µs\n";
+        std::cout << "  • Throughput: " << std::setprecision(0)
+                  << (num_messages * 1000000.0) / elapsed_us << " msgs/sec\n";
+        auto stats = book_.get_stats();
+        std::cout << "  • Active orders in book: " << stats.active_orders << "\n";
+
+        collector_.stop();
+        collector_.print();
+    }
+
+    static constexpr uint32_t TAG_QUEUE = 0;
+
+    Fifo3<OrderMessage> queue_;
+    OrderBook book_;
+    SpanCollector collector_;
+    int producer_core_;
+    int consumer_core_;
+
+    uint64_t start_ns_ = 0;
+    uint64_t end_ns_ = 0;
+};
+
+// ======================== MAIN FUNCTION ========================
+
+int main(int argc, char** argv) {
+    int num_messages = argc > 1 ? std::atoi(argv[1]) : 1000000;
+
+    std::cout << "════════════════════════════════════════\n";
+    std::cout << "   FEED → BOOK SPSC PIPELINE   \n";
+    std::cout << "════════════════════════════════════════\n";
+
+    FeedPipeline pipeline(/*queue_capacity=*/4096, /*producer_core=*/0, /*consumer_core=*/1);
+    pipeline.run(num_messages);
+    return 0;
+}
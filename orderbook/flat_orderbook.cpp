@@ -0,0 +1,348 @@
+// flat_orderbook.hpp - Cache-friendly flat tick-indexed order book engine
+// Compile: g++ -std=c++17 -O3 -march=native -DFLAT_ORDERBOOK_MAIN flat_orderbook.cpp -o flat_orderbook
+//
+// Alternative to the std::map-based OrderBook in orderbook.cpp. Levels inside a
+// fixed window around the reference price live in a contiguous array indexed by
+// integer tick offset, so add/cancel at or near the touch is one array access
+// instead of a red-black tree walk. Prices outside the window fall back to a
+// std::map so correctness never depends on the window size.
+
+#pragma once
+#include <cmath>
+#include "orderbook.cpp"
+
+// ======================== FLAT TICK-INDEXED BOOK ========================
+
+class FlatOrderBook {
+public:
+    // window_ticks slots on each side of the reference price are kept in the
+    // flat ladder; everything further away goes to the overflow map.
+    explicit FlatOrderBook(double tick_size = 0.01, int64_t window_ticks = 512)
+        : tick_size_(tick_size),
+          window_ticks_(window_ticks),
+          bids_(true, 2 * window_ticks + 1),
+          asks_(false, 2 * window_ticks + 1) {
+        order_lookup.reserve(10000);
+    }
+
+    ~FlatOrderBook() {
+        for (auto& [id, node] : order_lookup) {
+            order_pool.deallocate(node);
+        }
+        release_side(bids_);
+        release_side(asks_);
+    }
+
+    // Insert a new order into the book
+    void add_order(const Order& order) {
+        OrderNode* node = order_pool.allocate();
+        new(node) OrderNode(order, Price{to_tick(order.price)});
+
+        order_lookup.emplace(order.order_id, node);
+
+        Side& side = order.is_buy ? bids_ : asks_;
+        add_to_side(side, node);
+    }
+
+    // Cancel an existing order by its ID
+    [[nodiscard]] bool cancel_order(uint64_t order_id) {
+        auto it = order_lookup.find(order_id);
+        if (it == order_lookup.end()) {
+            return false;
+        }
+
+        OrderNode* node = it->second;
+        Side& side = node->order.is_buy ? bids_ : asks_;
+        remove_from_side(side, node);
+
+        order_lookup.erase(it);
+        order_pool.deallocate(node);
+        return true;
+    }
+
+    // Amend an existing order's price or quantity
+    [[nodiscard]] bool amend_order(uint64_t order_id, double new_price, uint64_t new_quantity) {
+        auto it = order_lookup.find(order_id);
+        if (it == order_lookup.end()) {
+            return false;
+        }
+
+        OrderNode* node = it->second;
+        if (to_tick(new_price) != to_tick(node->order.price)) {
+            // Price change: cancel and re-add to maintain FIFO
+            Order new_order = node->order;
+            new_order.price = new_price;
+            new_order.quantity = new_quantity;
+            (void)cancel_order(order_id);
+            add_order(new_order);
+        } else {
+            Side& side = node->order.is_buy ? bids_ : asks_;
+            Level* level = find_level(side, to_tick(node->order.price));
+            if (level) {
+                level->update_quantity(node, new_quantity);
+            }
+        }
+        return true;
+    }
+
+    // Get a snapshot of top N bid and ask levels
+    void get_snapshot(size_t depth, std::vector<PriceLevel>& bids, std::vector<PriceLevel>& asks) const {
+        bids.clear();
+        asks.clear();
+        bids.reserve(depth);
+        asks.reserve(depth);
+
+        collect_side(bids_, depth, bids);
+        collect_side(asks_, depth, asks);
+    }
+
+    // Get best bid and ask prices
+    [[nodiscard]] std::pair<double, double> get_best_prices() const {
+        double best_bid = bids_.level_count == 0 ? 0.0 : to_price(best_tick(bids_));
+        double best_ask = asks_.level_count == 0 ? std::numeric_limits<double>::max()
+                                                 : to_price(best_tick(asks_));
+        return {best_bid, best_ask};
+    }
+
+    [[nodiscard]] size_t active_orders() const { return order_lookup.size(); }
+
+    // Convert a snapshot tick price back to the external double representation
+    [[nodiscard]] double to_double(Price price) const {
+        return static_cast<double>(price.ticks) * tick_size_;
+    }
+
+private:
+    // One side of the book: a flat ladder of window slots plus an overflow map.
+    // base_tick is the tick of slots[0]; it is chosen when the first order of
+    // the side arrives and re-centred whenever the side drains empty.
+    struct Side {
+        Side(bool buy, size_t slot_count) : is_bid(buy), slots(slot_count, nullptr) {}
+
+        bool is_bid;
+        bool anchored = false;
+        int64_t base_tick = 0;
+        std::vector<Level*> slots;
+        std::map<int64_t, Level*> overflow;  // far-from-touch levels
+        size_t level_count = 0;
+    };
+
+    [[nodiscard]] int64_t to_tick(double price) const {
+        return static_cast<int64_t>(std::llround(price / tick_size_));
+    }
+    [[nodiscard]] double to_price(int64_t tick) const {
+        return static_cast<double>(tick) * tick_size_;
+    }
+
+    [[nodiscard]] bool in_window(const Side& side, int64_t tick) const {
+        return side.anchored
+            && tick >= side.base_tick
+            && tick < side.base_tick + static_cast<int64_t>(side.slots.size());
+    }
+
+    void add_to_side(Side& side, OrderNode* node) {
+        int64_t tick = to_tick(node->order.price);
+
+        // Anchor the window on the first order so the touch sits mid-window
+        if (!side.anchored) {
+            side.anchored = true;
+            side.base_tick = tick - window_ticks_;
+        }
+
+        Level* level;
+        if (in_window(side, tick)) {
+            Level*& slot = side.slots[tick - side.base_tick];
+            if (!slot) {
+                slot = new_level(Price{tick});
+                ++side.level_count;
+            }
+            level = slot;
+        } else {
+            auto it = side.overflow.find(tick);
+            if (it == side.overflow.end()) {
+                level = new_level(Price{tick});
+                side.overflow.emplace(tick, level);
+                ++side.level_count;
+            } else {
+                level = it->second;
+            }
+        }
+
+        level->add_order(node);
+    }
+
+    void remove_from_side(Side& side, OrderNode* node) {
+        int64_t tick = to_tick(node->order.price);
+        Level* level = find_level(side, tick);
+        if (!level) {
+            return;
+        }
+
+        level->remove_order(node);
+        if (level->is_empty()) {
+            if (in_window(side, tick)) {
+                side.slots[tick - side.base_tick] = nullptr;
+            } else {
+                side.overflow.erase(tick);
+            }
+            level_pool.deallocate(level);
+            --side.level_count;
+
+            // Re-centre the window next time once the side is fully drained
+            if (side.level_count == 0) {
+                side.anchored = false;
+            }
+        }
+    }
+
+    [[nodiscard]] Level* find_level(const Side& side, int64_t tick) const {
+        if (in_window(side, tick)) {
+            return side.slots[tick - side.base_tick];
+        }
+        auto it = side.overflow.find(tick);
+        return it == side.overflow.end() ? nullptr : it->second;
+    }
+
+    Level* new_level(Price price) {
+        Level* level = level_pool.allocate();
+        new(level) Level(price);
+        return level;
+    }
+
+    // Best tick of a side: scan the ladder from the aggressive end, then
+    // consult the overflow map. The ladder scan touches at most a few cache
+    // lines because occupied slots cluster around the touch.
+    [[nodiscard]] int64_t best_tick(const Side& side) const {
+        int64_t window_top = side.base_tick + static_cast<int64_t>(side.slots.size()) - 1;
+        if (side.is_bid) {
+            // Highest price wins: overflow above the window beats the ladder
+            auto it = side.overflow.rbegin();
+            if (it != side.overflow.rend() && it->first > window_top) {
+                return it->first;
+            }
+            for (int64_t t = window_top; side.anchored && t >= side.base_tick; --t) {
+                if (side.slots[t - side.base_tick]) return t;
+            }
+            return it != side.overflow.rend() ? it->first : 0;
+        } else {
+            auto it = side.overflow.begin();
+            if (it != side.overflow.end() && it->first < side.base_tick) {
+                return it->first;
+            }
+            for (int64_t t = side.base_tick; side.anchored && t <= window_top; ++t) {
+                if (side.slots[t - side.base_tick]) return t;
+            }
+            return it != side.overflow.end() ? it->first : 0;
+        }
+    }
+
+    // Walk a side best-first, merging ladder slots and overflow levels by price
+    void collect_side(const Side& side, size_t depth, std::vector<PriceLevel>& out) const {
+        if (side.level_count == 0) {
+            return;
+        }
+        int64_t window_top = side.base_tick + static_cast<int64_t>(side.slots.size()) - 1;
+
+        if (side.is_bid) {
+            auto it = side.overflow.rbegin();
+            // Overflow levels priced above the window
+            for (; it != side.overflow.rend() && it->first > window_top && out.size() < depth; ++it) {
+                out.emplace_back(PriceLevel{Price{it->first}, it->second->total_quantity});
+            }
+            for (int64_t t = window_top; side.anchored && t >= side.base_tick && out.size() < depth; --t) {
+                Level* level = side.slots[t - side.base_tick];
+                if (level) out.emplace_back(PriceLevel{Price{t}, level->total_quantity});
+            }
+            for (; it != side.overflow.rend() && out.size() < depth; ++it) {
+                out.emplace_back(PriceLevel{Price{it->first}, it->second->total_quantity});
+            }
+        } else {
+            auto it = side.overflow.begin();
+            // Overflow levels priced below the window
+            for (; it != side.overflow.end() && it->first < side.base_tick && out.size() < depth; ++it) {
+                out.emplace_back(PriceLevel{Price{it->first}, it->second->total_quantity});
+            }
+            for (int64_t t = side.base_tick; side.anchored && t <= window_top && out.size() < depth; ++t) {
+                Level* level = side.slots[t - side.base_tick];
+                if (level) out.emplace_back(PriceLevel{Price{t}, level->total_quantity});
+            }
+            for (; it != side.overflow.end() && out.size() < depth; ++it) {
+                out.emplace_back(PriceLevel{Price{it->first}, it->second->total_quantity});
+            }
+        }
+    }
+
+    void release_side(Side& side) {
+        for (Level* level : side.slots) {
+            if (level) level_pool.deallocate(level);
+        }
+        for (auto& [tick, level] : side.overflow) {
+            level_pool.deallocate(level);
+        }
+    }
+
+    MemoryPool<OrderNode, 1024> order_pool;
+    MemoryPool<Level, 256> level_pool;
+    std::unordered_map<uint64_t, OrderNode*> order_lookup;
+
+    double tick_size_;
+    int64_t window_ticks_;
+    Side bids_;
+    Side asks_;
+};
+
+// ======================== MAIN FUNCTION ========================
+
+#ifdef FLAT_ORDERBOOK_MAIN
+int main() {
+    FlatOrderBook book(0.01, 512);
+
+    book.add_order({1, true, 99.95, 1000, 1});
+    book.add_order({2, true, 99.90, 2000, 2});
+    book.add_order({3, false, 100.05, 1000, 3});
+    book.add_order({4, false, 100.10, 2000, 4});
+    book.add_order({5, true, 50.00, 500, 5});   // far from touch -> overflow map
+
+    std::vector<PriceLevel> bids, asks;
+    book.get_snapshot(5, bids, asks);
+
+    std::cout << "Bids: ";
+    for (const auto& lvl : bids) std::cout << "[" << book.to_double(lvl.price) << ":" << lvl.total_quantity << "] ";
+    std::cout << "\nAsks: ";
+    for (const auto& lvl : asks) std::cout << "[" << book.to_double(lvl.price) << ":" << lvl.total_quantity << "] ";
+    std::cout << "\n";
+
+    auto [bid, ask] = book.get_best_prices();
+    std::cout << "Best bid: " << bid << "  Best ask: " << ask << "\n";
+
+    if (!book.cancel_order(1)) std::cout << "cancel failed\n";
+    if (!book.amend_order(2, 99.90, 2500)) std::cout << "amend failed\n";
+
+    std::tie(bid, ask) = book.get_best_prices();
+    std::cout << "After cancel/amend -> Best bid: " << bid << "  Best ask: " << ask << "\n";
+
+    // Throughput sanity check against the hot window
+    FlatOrderBook perf(0.01, 512);
+    const int num_orders = 1000000;
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<> tick_dist(-400, 400);
+    std::uniform_int_distribution<> quantity_dist(100, 1000);
+    std::uniform_int_distribution<> side_dist(0, 1);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < num_orders; ++i) {
+        perf.add_order({
+            static_cast<uint64_t>(i),
+            side_dist(gen) == 0,
+            100.0 + tick_dist(gen) * 0.01,
+            static_cast<uint64_t>(quantity_dist(gen)),
+            0
+        });
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+    std::cout << "\nFlat ladder add throughput: "
+              << (num_orders * 1000000.0) / duration.count() << " orders/sec\n";
+    return 0;
+}
+#endif
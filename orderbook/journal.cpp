@@ -0,0 +1,392 @@
+// journal.hpp - Binary event journal and replay harness for the OrderBook
+// Compile: g++ -std=c++17 -O3 -march=native -DJOURNAL_MAIN journal.cpp -o journal
+//
+// The tester benchmarks against uniform-random synthetic orders, which has
+// nothing like the price locality or cancel/add ratio of a real feed. The
+// journal captures live flow as fixed-size binary records (one per
+// add/cancel/amend) so a day of production traffic can be replayed through
+// the book and measured with the same metrics the tester prints.
+
+#pragma once
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "orderbook.cpp"
+
+// ======================== JOURNAL RECORD FORMAT ========================
+
+// Fixed-size, layout-stable journal record mirroring Order plus an op code.
+// Records are written and read as raw bytes; keep the layout explicit. The
+// record is deliberately NOT a memcpy of Order: the in-memory struct is free
+// to repack (and has), while this wire layout stays pinned by the asserts
+// below — old journals replay unchanged.
+struct JournalRecord {
+    uint8_t  op;            // JournalOp
+    uint8_t  is_buy;
+    uint8_t  reserved[6];   // Explicit padding, always zero
+    uint64_t order_id;
+    double   price;
+    uint64_t quantity;
+    uint64_t timestamp_ns;
+};
+
+enum JournalOp : uint8_t {
+    JOURNAL_ADD = 0,
+    JOURNAL_CANCEL = 1,
+    JOURNAL_AMEND = 2,
+};
+
+// The mmap reader hands out pointers straight into the file, so the on-disk
+// bytes ARE the in-memory struct. Pin every offset, not just the total size:
+// a reordered field would still pass a sizeof check.
+static_assert(sizeof(JournalRecord) == 40, "journal record layout changed");
+static_assert(offsetof(JournalRecord, op) == 0);
+static_assert(offsetof(JournalRecord, is_buy) == 1);
+static_assert(offsetof(JournalRecord, order_id) == 8);
+static_assert(offsetof(JournalRecord, price) == 16);
+static_assert(offsetof(JournalRecord, quantity) == 24);
+static_assert(offsetof(JournalRecord, timestamp_ns) == 32);
+static_assert(std::is_trivially_copyable<JournalRecord>::value);
+
+// ======================== WRITER ========================
+
+// Appends records through stdio's buffer; one fwrite per record, flushed on
+// close. Capture-side overhead is a 40-byte memcpy into the stream buffer.
+class JournalWriter {
+public:
+    explicit JournalWriter(const std::string& path)
+        : file_(std::fopen(path.c_str(), "wb")) {
+        if (!file_) {
+            throw std::runtime_error("JournalWriter: cannot open " + path);
+        }
+    }
+
+    ~JournalWriter() {
+        if (file_) {
+            std::fclose(file_);
+        }
+    }
+
+    JournalWriter(const JournalWriter&) = delete;
+    JournalWriter& operator=(const JournalWriter&) = delete;
+
+    void append(JournalOp op, const Order& order) {
+        JournalRecord rec{};
+        rec.op = op;
+        rec.is_buy = order.is_buy ? 1 : 0;
+        rec.order_id = order.order_id;
+        rec.price = order.price;
+        rec.quantity = order.quantity;
+        rec.timestamp_ns = order.timestamp_ns;
+        std::fwrite(&rec, sizeof(rec), 1, file_);
+        ++records_;
+    }
+
+    [[nodiscard]] uint64_t record_count() const { return records_; }
+
+private:
+    FILE* file_;
+    uint64_t records_ = 0;
+};
+
+// ======================== BOOK HOOK ========================
+
+// Journaling hook: wraps a book and appends one record per mutation before
+// forwarding. Wrap the live book with this in capture runs; replay and
+// normal runs use the raw book.
+template<typename Book = OrderBook>
+class JournaledBook {
+public:
+    JournaledBook(Book& book, JournalWriter& writer) : book_(book), writer_(writer) {}
+
+    void add_order(const Order& order) {
+        writer_.append(JOURNAL_ADD, order);
+        book_.add_order(order);
+    }
+
+    [[nodiscard]] bool cancel_order(uint64_t order_id) {
+        writer_.append(JOURNAL_CANCEL, Order{order_id, false, 0.0, 0, 0});
+        return book_.cancel_order(order_id);
+    }
+
+    [[nodiscard]] bool amend_order(uint64_t order_id, double new_price, uint64_t new_quantity) {
+        writer_.append(JOURNAL_AMEND, Order{order_id, false, new_price, new_quantity, 0});
+        return book_.amend_order(order_id, new_price, new_quantity);
+    }
+
+    [[nodiscard]] Book& book() { return book_; }
+
+private:
+    Book& book_;
+    JournalWriter& writer_;
+};
+
+// ======================== MAPPED READER ========================
+
+// Zero-copy journal reader: mmaps the whole file and exposes it as a span of
+// JournalRecord. No fread, no deserialize — the record pointer points into
+// the page cache, and madvise(MADV_SEQUENTIAL) tells the kernel to read
+// ahead aggressively and drop pages behind the cursor.
+class MappedJournal {
+public:
+    explicit MappedJournal(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("MappedJournal: cannot open " + path);
+        }
+
+        struct stat st{};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("MappedJournal: fstat failed on " + path);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ % sizeof(JournalRecord) != 0) {
+            ::close(fd);
+            throw std::runtime_error("MappedJournal: truncated journal " + path);
+        }
+
+        if (size_ > 0) {
+            void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("MappedJournal: mmap failed on " + path);
+            }
+            ::madvise(addr, size_, MADV_SEQUENTIAL);
+            base_ = static_cast<const JournalRecord*>(addr);
+        }
+        ::close(fd);  // mapping keeps the file alive
+    }
+
+    ~MappedJournal() {
+        if (base_) {
+            ::munmap(const_cast<JournalRecord*>(base_), size_);
+        }
+    }
+
+    MappedJournal(const MappedJournal&) = delete;
+    MappedJournal& operator=(const MappedJournal&) = delete;
+
+    [[nodiscard]] const JournalRecord* begin() const { return base_; }
+    [[nodiscard]] const JournalRecord* end() const { return base_ + record_count(); }
+    [[nodiscard]] size_t record_count() const { return size_ / sizeof(JournalRecord); }
+    [[nodiscard]] const JournalRecord& operator[](size_t i) const { return base_[i]; }
+
+private:
+    const JournalRecord* base_ = nullptr;
+    size_t size_ = 0;
+};
+
+// ======================== REPLAY ========================
+
+// Streams a captured journal through a fresh book and reports the same
+// throughput/latency metrics as OrderBookTester::run_performance_test.
+class JournalReplayer {
+public:
+    explicit JournalReplayer(const std::string& path) : path_(path) {}
+
+    template<typename Book>
+    void replay(Book& book) {
+        FILE* file = std::fopen(path_.c_str(), "rb");
+        if (!file) {
+            throw std::runtime_error("JournalReplayer: cannot open " + path_);
+        }
+
+        // Read in big chunks so replay cost is the book, not stdio
+        std::vector<JournalRecord> chunk(16384);
+        uint64_t total = 0;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        size_t n;
+        while ((n = std::fread(chunk.data(), sizeof(JournalRecord), chunk.size(), file)) > 0) {
+            for (size_t i = 0; i < n; ++i) {
+                apply(book, chunk[i]);
+            }
+            total += n;
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::fclose(file);
+
+        report(total, std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+    }
+
+    /// Zero-copy variant: applies records straight out of the mapping,
+    /// so replay touches each byte exactly once.
+    template<typename Book>
+    void replay_mapped(Book& book) {
+        MappedJournal journal(path_);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (const JournalRecord& rec : journal) {
+            apply(book, rec);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        report(journal.record_count(),
+               std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+    }
+
+    // Warm-up priming (the optional third stage of OrderBook::warm_up):
+    // replay a captured journal into a scratch book drawing from the
+    // caller's shared pools, then discard the book. The pools come back hot
+    // — blocks allocated, free lists seeded with every node the replay
+    // touched — and the replay walks exactly the session's code paths, so
+    // branch predictors and icache are warm before the first live packet.
+    // The authoritative book then starts empty on the same pools.
+    template<typename StatsPolicy>
+    static void prime(BookPools<StatsPolicy>& pools, const std::string& path,
+                      size_t expected_orders = 10000) {
+        MappedJournal journal(path);
+        BasicOrderBook<StatsPolicy> scratch(pools, 0.01, 10, expected_orders);
+        for (const JournalRecord& rec : journal) {
+            apply(scratch, rec);
+        }
+        std::cout << "  • Primed pools with " << journal.record_count()
+                  << " journaled events\n";
+    }
+
+    template<typename Book>
+    static inline void apply(Book& book, const JournalRecord& rec) {
+        switch (rec.op) {
+            case JOURNAL_ADD:
+                book.add_order(Order{rec.order_id, rec.is_buy != 0, rec.price,
+                                     rec.quantity, rec.timestamp_ns});
+                break;
+            case JOURNAL_CANCEL:
+                (void)book.cancel_order(rec.order_id);
+                break;
+            case JOURNAL_AMEND:
+                (void)book.amend_order(rec.order_id, rec.price, rec.quantity);
+                break;
+            default:
+                break;
+        }
+    }
+
+    static void report(uint64_t events, long long micros) {
+        std::cout << "\n╔════════════════════════════════╗\n";
+        std::cout << "║       JOURNAL REPLAY            ║\n";
+        std::cout << "╚════════════════════════════════╝\n";
+        std::cout << "  • Events replayed: " << events << "\n";
+        std::cout << "  • Total time: " << micros << " µs\n";
+        std::cout << std::fixed << std::setprecision(3);
+        std::cout << "  • Per event: " << micros / static_cast<double>(events) << " µs\n";
+        std::cout << std::setprecision(0);
+        std::cout << "  • Throughput: " << (events * 1000000.0) / micros << " events/sec\n";
+    }
+
+private:
+    std::string path_;
+};
+
+// ======================== MAIN FUNCTION ========================
+
+#ifdef JOURNAL_MAIN
+// Capture a synthetic-but-realistic session (price random walk around a
+// drifting mid, ~50% adds / 35% cancels / 15% amends) and replay it.
+int main(int argc, char** argv) {
+    const std::string path = argc > 1 ? argv[1] : "/tmp/orderbook.journal";
+    const int num_events = argc > 2 ? std::atoi(argv[2]) : 1000000;
+
+    {
+        OrderBook book;
+        JournalWriter writer(path);
+        JournaledBook<> journaled(book, writer);
+
+        std::mt19937 gen(42);
+        std::normal_distribution<> offset_dist(0.0, 5.0);
+        std::uniform_int_distribution<> quantity_dist(100, 1000);
+        std::uniform_int_distribution<> side_dist(0, 1);
+        std::uniform_int_distribution<> action_dist(0, 99);
+
+        double mid = 100.0;
+        uint64_t next_id = 1;
+        std::vector<uint64_t> live;
+        live.reserve(num_events);
+
+        for (int i = 0; i < num_events; ++i) {
+            mid += (gen() % 2 ? 0.01 : -0.01);  // drifting reference price
+            int action = action_dist(gen);
+            double px = mid + static_cast<int>(offset_dist(gen)) * 0.01;
+
+            if (action < 50 || live.empty()) {
+                journaled.add_order({next_id, side_dist(gen) == 0, px,
+                                     static_cast<uint64_t>(quantity_dist(gen)), 0});
+                live.push_back(next_id++);
+            } else if (action < 85) {
+                size_t k = gen() % live.size();
+                if (journaled.cancel_order(live[k])) {
+                    live[k] = live.back();
+                    live.pop_back();
+                }
+            } else {
+                size_t k = gen() % live.size();
+                (void)journaled.amend_order(live[k], px,
+                                            static_cast<uint64_t>(quantity_dist(gen)));
+            }
+        }
+        std::cout << "Captured " << writer.record_count() << " records to " << path << "\n";
+    }
+
+    JournalReplayer replayer(path);
+
+    {
+        OrderBook replay_book;
+        replayer.replay(replay_book);
+        std::cout << "  • Active orders after replay (fread): "
+                  << replay_book.get_stats().active_orders << "\n";
+    }
+    {
+        OrderBook replay_book;
+        replayer.replay_mapped(replay_book);
+        std::cout << "  • Active orders after replay (mmap):  "
+                  << replay_book.get_stats().active_orders << "\n";
+    }
+
+    // Warm-up payoff: time the first adds on a cold book vs one with
+    // pre-faulted pools, a pre-sized table, and a priming replay behind it
+    {
+        auto first_adds = [](OrderBook& book, int n) {
+            uint64_t worst = 0;
+            auto t0 = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < n; ++i) {
+                auto s = std::chrono::high_resolution_clock::now();
+                book.add_order({static_cast<uint64_t>(1 + i), (i % 2) == 0,
+                                100.0 + (i % 40) * 0.01, 100, 0});
+                auto e = std::chrono::high_resolution_clock::now();
+                worst = std::max<uint64_t>(worst,
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(e - s).count());
+            }
+            auto t1 = std::chrono::high_resolution_clock::now();
+            auto total = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+            return std::pair<uint64_t, uint64_t>(total / n, worst);
+        };
+
+        const int first = 10000;
+        std::cout << "\nFirst " << first << " adds at the open:\n";
+        {
+            OrderBook cold;
+            auto [mean_ns, worst_ns] = first_adds(cold, first);
+            std::cout << "  • Cold book:   mean " << mean_ns
+                      << " ns, worst " << worst_ns << " ns\n";
+        }
+        {
+            BookPools<DefaultStats> pools;
+            JournalReplayer::prime(pools, path, 1 << 20);
+            OrderBook warm(pools, 0.01, 10, 1 << 20);
+            warm.warm_up(1 << 20, 1 << 14);
+            auto [mean_ns, worst_ns] = first_adds(warm, first);
+            std::cout << "  • Warmed book: mean " << mean_ns
+                      << " ns, worst " << worst_ns << " ns\n";
+        }
+    }
+    return 0;
+}
+#endif
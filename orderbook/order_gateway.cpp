@@ -0,0 +1,273 @@
+// order_gateway.hpp - outbound order-entry path: in-place wire serialization
+// Compile: g++ -std=c++17 -O3 -march=native -DORDER_GATEWAY_MAIN order_gateway.cpp -o order_gateway -pthread
+//
+// The real version of the L2/mocks sketches: pass_by_value.cpp left
+// sendOrderToExchange() as an empty stub, and struct_by_pointer.cpp showed
+// the trick that makes it fast — a struct laid directly over the wire
+// buffer, so serialization is field stores rather than text formatting.
+// The current gateway formats orders with ostringstream at ~2µs per order;
+// here the wire message is a layout-pinned 40-byte struct (same discipline
+// as JournalRecord), written in place into a preallocated ring of wire
+// buffers. Strategy threads hand orders to a Vyukov MPMC queue (fan-in from
+// any number of producers) and a single writer thread drains them in
+// batches, serializes into consecutive ring buffers, and ships each batch
+// with one writev. Per-order enqueue-to-syscall latency goes through
+// SpanCollector, so the tail of the outbound path is a number, not a guess.
+
+#pragma once
+#include <cstddef>
+#include <cstring>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "orderbook.cpp"
+#include "../SPSC_QUEUES/mpmc_q.cpp"
+
+// ======================== WIRE FORMAT ========================
+
+// New-order message as it leaves the box. Field offsets are pinned with
+// static_asserts so a refactor cannot silently change what the exchange
+// sees; bump version when the layout must evolve.
+struct WireNewOrder {
+    uint16_t magic;          // 'E' << 8 | 'O'
+    uint8_t version;
+    uint8_t is_buy;
+    uint32_t seq;            // gateway-assigned, strictly increasing
+    uint64_t order_id;
+    double price;
+    uint64_t quantity;
+    uint64_t client_ts_ns;
+
+    static constexpr uint16_t MAGIC = ('E' << 8) | 'O';
+    static constexpr uint8_t VERSION = 1;
+};
+static_assert(sizeof(WireNewOrder) == 40, "wire layout changed; bump VERSION");
+static_assert(offsetof(WireNewOrder, magic) == 0, "wire layout drift");
+static_assert(offsetof(WireNewOrder, seq) == 4, "wire layout drift");
+static_assert(offsetof(WireNewOrder, order_id) == 8, "wire layout drift");
+static_assert(offsetof(WireNewOrder, price) == 16, "wire layout drift");
+static_assert(offsetof(WireNewOrder, quantity) == 24, "wire layout drift");
+static_assert(offsetof(WireNewOrder, client_ts_ns) == 32, "wire layout drift");
+static_assert(std::is_trivially_copyable_v<WireNewOrder>,
+              "wire message must be a plain byte image");
+
+// In-place serializer: lays the message struct over the caller's buffer and
+// stores fields — no intermediate string, no stream state, no allocation
+inline size_t serialize_new_order(const Order& order, uint32_t seq,
+                                  unsigned char* buffer) {
+    auto* msg = reinterpret_cast<WireNewOrder*>(buffer);
+    msg->magic = WireNewOrder::MAGIC;
+    msg->version = WireNewOrder::VERSION;
+    msg->is_buy = order.is_buy ? 1 : 0;
+    msg->seq = seq;
+    msg->order_id = order.order_id;
+    msg->price = order.price;
+    msg->quantity = order.quantity;
+    msg->client_ts_ns = order.timestamp_ns;
+    return sizeof(WireNewOrder);
+}
+
+// ======================== GATEWAY ========================
+
+// Fan-in gateway: any thread calls send(); one writer thread owns the fd.
+// The wire-buffer ring is preallocated at construction, so the steady-state
+// path performs zero allocations: pop, field stores, writev.
+class OrderGateway {
+public:
+    static constexpr size_t QUEUE_CAPACITY = 4096;
+    static constexpr size_t BATCH_SIZE = 64;      // orders per writev
+
+    explicit OrderGateway(int fd)
+        : fd_(fd), queue_(QUEUE_CAPACITY),
+          writer_thread_([this] { drain_loop(); }) {
+        collector_.set_tag_name(TAG_ENQUEUE_TO_SYSCALL, "enqueue->syscall");
+    }
+
+    ~OrderGateway() { stop(); }
+
+    // Producer side, callable from any strategy thread. Returns false when
+    // the queue is full (exchange session backed up) — the caller decides
+    // whether to retry or reject.
+    bool send(const Order& order) {
+        return queue_.push(Pending{order, TscClock::cycles()});
+    }
+
+    // Flush remaining orders and join the writer (idempotent)
+    void stop() {
+        if (!stopped_.exchange(true)) {
+            writer_thread_.join();
+            collector_.stop();
+        }
+    }
+
+    void report() {
+        stop();
+        std::cout << "gateway: " << orders_sent_ << " orders in "
+                  << syscalls_ << " syscalls ("
+                  << (syscalls_ ? orders_sent_ / syscalls_ : 0)
+                  << " orders/writev)\n";
+        collector_.print();
+    }
+
+    [[nodiscard]] uint64_t orders_sent() const { return orders_sent_; }
+
+private:
+    static constexpr uint32_t TAG_ENQUEUE_TO_SYSCALL = 0;
+
+    struct Pending {
+        Order order;
+        uint64_t enqueue_cycles;
+    };
+
+    void drain_loop() {
+        Pending batch[BATCH_SIZE];
+        iovec iov[BATCH_SIZE];
+        for (;;) {
+            size_t n = 0;
+            while (n < BATCH_SIZE && queue_.pop(batch[n])) ++n;
+            if (n == 0) {
+                if (stopped_.load(std::memory_order_acquire)) break;
+                std::this_thread::sleep_for(std::chrono::microseconds(10));
+                continue;
+            }
+
+            for (size_t i = 0; i < n; ++i) {
+                unsigned char* buf = wire_buffers_[i];
+                iov[i].iov_base = buf;
+                iov[i].iov_len = serialize_new_order(batch[i].order, next_seq_++, buf);
+            }
+
+            // Stamp the batch once, right before the syscall: this is the
+            // "order left our process" moment the latency budget is against
+            uint64_t syscall_cycles = TscClock::cycles();
+            for (size_t i = 0; i < n; ++i) {
+                collector_.record(TAG_ENQUEUE_TO_SYSCALL,
+                                  batch[i].enqueue_cycles, syscall_cycles);
+            }
+
+            write_all(iov, n);
+            orders_sent_ += n;
+            ++syscalls_;
+        }
+    }
+
+    // writev with short-write handling; a dead fd drops the batch (the
+    // session layer above us owns reconnect/replay)
+    void write_all(iovec* iov, size_t count) {
+        size_t idx = 0;
+        while (idx < count) {
+            ssize_t written = ::writev(fd_, iov + idx, static_cast<int>(count - idx));
+            if (written < 0) return;
+            while (idx < count && static_cast<size_t>(written) >= iov[idx].iov_len) {
+                written -= static_cast<ssize_t>(iov[idx].iov_len);
+                ++idx;
+            }
+            if (idx < count && written > 0) {
+                iov[idx].iov_base = static_cast<unsigned char*>(iov[idx].iov_base) + written;
+                iov[idx].iov_len -= static_cast<size_t>(written);
+            }
+        }
+    }
+
+    int fd_;
+    MpmcQueue<Pending> queue_;
+    alignas(64) unsigned char wire_buffers_[BATCH_SIZE][sizeof(WireNewOrder)];
+    uint32_t next_seq_ = 0;
+    uint64_t orders_sent_ = 0;
+    uint64_t syscalls_ = 0;
+    SpanCollector collector_;
+    std::atomic<bool> stopped_{false};
+    std::thread writer_thread_;
+};
+
+// ======================== MAIN FUNCTION ========================
+
+#ifdef ORDER_GATEWAY_MAIN
+#include <sstream>
+
+int main() {
+    // Exchange stand-in: a pipe with a validator draining it
+    int fds[2];
+    if (::pipe(fds) != 0) {
+        std::cerr << "pipe failed\n";
+        return 1;
+    }
+
+    std::atomic<uint64_t> received{0};
+    std::atomic<uint64_t> corrupt{0};
+    std::thread exchange([&] {
+        WireNewOrder msg;
+        uint32_t expected_seq = 0;
+        unsigned char buf[sizeof(WireNewOrder)];
+        size_t have = 0;
+        for (;;) {
+            ssize_t n = ::read(fds[0], buf + have, sizeof(buf) - have);
+            if (n <= 0) break;
+            have += static_cast<size_t>(n);
+            if (have < sizeof(buf)) continue;
+            have = 0;
+            std::memcpy(&msg, buf, sizeof(msg));
+            if (msg.magic != WireNewOrder::MAGIC || msg.seq != expected_seq++) {
+                corrupt.fetch_add(1, std::memory_order_relaxed);
+            }
+            received.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    // Two strategy threads fanning into one gateway
+    {
+        OrderGateway gateway(fds[1]);
+        const int per_producer = 50000;
+        auto producer = [&](uint64_t id_base) {
+            std::mt19937 gen(static_cast<unsigned>(id_base));
+            std::uniform_real_distribution<> px(99.0, 101.0);
+            for (int i = 0; i < per_producer; ++i) {
+                Order o{id_base + i, (i % 2) == 0, px(gen),
+                        static_cast<uint64_t>(1 + i % 500), TscClock::now_ns()};
+                while (!gateway.send(o)) {
+                    std::this_thread::yield();
+                }
+            }
+        };
+        std::thread p1(producer, 1000000);
+        std::thread p2(producer, 2000000);
+        p1.join();
+        p2.join();
+        gateway.report();
+    }
+    ::close(fds[1]);
+    exchange.join();
+    ::close(fds[0]);
+
+    std::cout << "exchange side: " << received << " messages, "
+              << corrupt << " corrupt/out-of-seq\n";
+
+    // The number this file exists to fix: in-place stores vs ostringstream
+    const int reps = 100000;
+    Order o{42, true, 100.25, 100, 123456789};
+    unsigned char wire[sizeof(WireNewOrder)];
+    volatile size_t sink = 0;
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < reps; ++i) {
+        sink += serialize_new_order(o, static_cast<uint32_t>(i), wire);
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < reps; ++i) {
+        std::ostringstream oss;
+        oss << "NEW," << i << ',' << o.order_id << ',' << (o.is_buy ? 'B' : 'S')
+            << ',' << o.price << ',' << o.quantity;
+        sink += oss.str().size();
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    auto ns = [](auto a, auto b) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(b - a).count();
+    };
+    std::cout << "serialization per order: in-place " << ns(t0, t1) / reps
+              << " ns vs ostringstream " << ns(t1, t2) / reps << " ns (sink "
+              << sink % 10 << ")\n";
+    return corrupt == 0 ? 0 : 1;
+}
+#endif
@@ -1,14 +1,19 @@
 // order_book.hpp - Complete High-Performance Limit Order Book Implementation
 // Compile: g++ -std=c++17 -O3 -march=native -DORDERBOOK_MAIN order_book.cpp -o orderbook
 // For best performance: g++ -std=c++17 -O3 -march=native -flto -DNDEBUG -DORDERBOOK_MAIN order_book.cpp -o orderbook
+// With profile feedback: ./pgo_bench.sh (trains on journal replay, reports the delta)
 
 #pragma once
 #include <cstdint>
+#include <cmath>
+#include <array>
+#include <atomic>
 #include <vector>
 #include <map>
 #include <unordered_map>
 #include <list>
 #include <memory>
+#include <new>
 #include <iostream>
 #include <iomanip>
 #include <chrono>
@@ -18,136 +23,621 @@
 #include <random>
 #include <sstream>
 
+#include "timing.cpp"
+
+// ======================== BRANCH HINTS ========================
+
+// Same macros as L9/branches.cpp (C++17, so no [[likely]] attribute).
+// Applied only where journal replay shows strong bias: not-found rejects,
+// pool block exhaustion, new-level creation. Define ORDERBOOK_NO_HINTS to
+// compile them out and measure the difference with the tester's replay
+// benchmark.
+#ifndef ORDERBOOK_NO_HINTS
+#define OB_LIKELY(x)   __builtin_expect(!!(x), 1)
+#define OB_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#define OB_PREFETCH(p) __builtin_prefetch(p)
+#else
+#define OB_LIKELY(x)   (x)
+#define OB_UNLIKELY(x) (x)
+#define OB_PREFETCH(p) ((void)0)
+#endif
+
 // ======================== CORE DATA STRUCTURES ========================
 
-// Order structure
+// Integer fixed-point price: a count of ticks at the owning book's tick size.
+// Integer keys compare in one instruction, pack tighter in the level maps and
+// remove the epsilon comparisons that raw double keys forced on amend.
+struct Price {
+    int64_t ticks;
+
+    friend constexpr bool operator==(Price a, Price b) { return a.ticks == b.ticks; }
+    friend constexpr bool operator!=(Price a, Price b) { return a.ticks != b.ticks; }
+    friend constexpr bool operator<(Price a, Price b)  { return a.ticks < b.ticks; }
+    friend constexpr bool operator>(Price a, Price b)  { return a.ticks > b.ticks; }
+    friend constexpr bool operator<=(Price a, Price b) { return a.ticks <= b.ticks; }
+    friend constexpr bool operator>=(Price a, Price b) { return a.ticks >= b.ticks; }
+};
+
+// Order structure (external message format; prices arrive as doubles and are
+// converted to ticks once at the book boundary). Fields are packed widest
+// first so the only padding is at the tail (see L5/padding.cpp); the
+// constructor keeps the historical (id, side, price, qty, ts) argument
+// order, so call sites and the pinned journal/checkpoint wire formats are
+// unaffected by the member layout.
 struct Order {
     uint64_t order_id;
-    bool is_buy;
     double price;
     uint64_t quantity;
     uint64_t timestamp_ns;
+    bool is_buy;
+
+    Order() = default;
+    Order(uint64_t id, bool buy, double px, uint64_t qty, uint64_t ts)
+        : order_id(id), price(px), quantity(qty), timestamp_ns(ts), is_buy(buy) {}
 };
+static_assert(sizeof(Order) == 40, "Order grew: four u64-wide fields + side byte");
+static_assert(alignof(Order) == 8, "Order alignment changed");
+static_assert(std::is_trivially_copyable_v<Order>, "Order must stay a byte image");
 
 // Price level aggregation for snapshots
 struct PriceLevel {
-    double price;
+    Price price;
     uint64_t total_quantity;
 };
+static_assert(sizeof(PriceLevel) == 16, "PriceLevel layout changed: 4 per cache line");
+
+// Trade report emitted by the matching engine. Reports are written into a
+// caller-supplied buffer so matching never allocates per trade.
+struct Trade {
+    uint64_t maker_order_id;   // Resting order that was filled
+    uint64_t taker_order_id;   // Aggressive order that crossed
+    Price price;               // Execution price (maker's level)
+    uint64_t quantity;
+};
+static_assert(sizeof(Trade) == 32, "Trade layout changed: 2 per cache line");
+
+// One decoded feed event, batched through apply_batch(). For cancels only
+// order.order_id is read; for amends order.price/quantity carry the new
+// values.
+struct BookUpdate {
+    enum class Op : uint8_t { Add, Cancel, Amend };
+    Op op;
+    Order order;
+};
+
+// ======================== STATS POLICY ========================
+
+// Compile-time instrumentation switch. Hot-path counters cost measurable
+// store traffic at -O3 and defeat some vectorization, so production builds
+// compile them out entirely: flip the DefaultStats alias (or instantiate
+// BasicOrderBook<StatsDisabled> directly) to choose between the "measured"
+// and "maximum speed" variants. Dev builds keep print_stats/
+// print_detailed_stats fully working.
+struct StatsEnabled  { static constexpr bool enabled = true; };
+struct StatsDisabled { static constexpr bool enabled = false; };
+
+#ifdef NDEBUG
+using DefaultStats = StatsDisabled;
+#else
+using DefaultStats = StatsEnabled;
+#endif
+
+// ======================== LISTENER POLICY ========================
+
+// Compile-time event hooks on the book's mutation paths. A virtual listener
+// (the L6/inheritance.cpp pattern) would put an indirect call on every
+// add/cancel/amend at feed rate, so the listener is a template parameter
+// instead: the book calls these directly and the optimizer inlines them
+// into the mutation functions. The default NullListener's empty bodies
+// compile to nothing — a book without a listener pays zero, not even a
+// test-and-branch. Journal writers, delta publishers and risk checks all
+// hang off this one mechanism. Hooks fire after the book has applied the
+// event, so a hook that reads the book sees post-event state; on_cancel
+// runs before the node returns to the pool. restore_sorted() is bulk state
+// reconstruction, not events, and fires no hooks.
+struct NullListener {
+    inline void on_add(const Order&) {}
+    inline void on_cancel(const Order&) {}
+    inline void on_amend(const Order&) {}       // order carries amended values
+    inline void on_trade(const Trade&) {}
+};
+
+// High-dynamic-range latency histogram: log2 major buckets with 32 linear
+// sub-buckets each, so relative error is bounded at ~3% across the whole ns
+// range — enough resolution to state a p99.9 honestly, which plain log2
+// buckets (factor-of-2 error) cannot. Fixed memory, constant-time record,
+// nothing allocated on the measurement path. Only instantiated when stats
+// are enabled.
+struct LatencyHistogram {
+    static constexpr int MAJORS = 32;      // powers of two of nanoseconds
+    static constexpr int SUBS = 32;        // linear subdivisions per power
+
+    uint64_t buckets[MAJORS][SUBS] = {};
+    uint64_t count = 0;
+    uint64_t max_ns = 0;
+
+    inline void record(uint64_t ns) {
+        int major = ns == 0 ? 0 : std::min(MAJORS - 1, 64 - __builtin_clzll(ns));
+        // Position within [2^(major-1), 2^major), scaled to SUBS slots
+        int sub = major < 6 ? 0
+                            : static_cast<int>((ns >> (major - 6)) & (SUBS - 1));
+        ++buckets[major][sub];
+        ++count;
+        max_ns = std::max(max_ns, ns);
+    }
+
+    // Upper bound of the bucket holding the requested rank
+    [[nodiscard]] uint64_t percentile(double p) const {
+        if (count == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(count * p);
+        uint64_t seen = 0;
+        for (int major = 0; major < MAJORS; ++major) {
+            for (int sub = 0; sub < SUBS; ++sub) {
+                seen += buckets[major][sub];
+                if (seen > rank) {
+                    if (major < 6) return uint64_t{1} << major;
+                    uint64_t base = uint64_t{1} << (major - 1);
+                    uint64_t step = base / SUBS;
+                    return base + step * (sub + 1);
+                }
+            }
+        }
+        return max_ns;
+    }
+
+    void print(const char* name) const {
+        std::cout << "  " << std::left << std::setw(14) << name << std::right
+                  << std::setw(10) << count
+                  << std::setw(9) << percentile(0.50)
+                  << std::setw(9) << percentile(0.90)
+                  << std::setw(9) << percentile(0.99)
+                  << std::setw(9) << percentile(0.999)
+                  << std::setw(10) << max_ns << "\n";
+    }
+
+    static void print_header() {
+        std::cout << "  " << std::left << std::setw(14) << "op" << std::right
+                  << std::setw(10) << "samples"
+                  << std::setw(9) << "p50"
+                  << std::setw(9) << "p90"
+                  << std::setw(9) << "p99"
+                  << std::setw(9) << "p99.9"
+                  << std::setw(10) << "max(ns)" << "\n";
+    }
+};
 
 // ======================== MEMORY POOL IMPLEMENTATION ========================
 
+// Counters for MemoryPool; the disabled specialization is an empty base so
+// the counters (and their stores) vanish from production builds
+template<bool Enabled>
+struct PoolCounters {
+    size_t total_allocations = 0;
+    size_t total_deallocations = 0;
+    size_t blocks_allocated = 0;
+};
+template<>
+struct PoolCounters<false> {};
+
+// Backing storage policy for MemoryPool blocks. The default draws from the
+// global heap; backing_storage.cpp provides huge-page and NUMA-bound
+// policies with the same two static functions.
+struct HeapBacking {
+    static void* allocate(size_t bytes, size_t alignment) {
+        return ::operator new(bytes, std::align_val_t{alignment});
+    }
+    static void deallocate(void* ptr, size_t /*bytes*/, size_t alignment) {
+        ::operator delete(ptr, std::align_val_t{alignment});
+    }
+};
+
+// Unique-ownership handle over a pool object; declared here so MemoryPool
+// can hand them out, defined after the pool
+template<typename Pool>
+class PoolPtr;
+
 // High-performance memory pool with aligned allocation
-template<typename T, size_t BlockSize = 4096>
-class MemoryPool {
+template<typename T, size_t BlockSize = 4096, typename StatsPolicy = DefaultStats,
+         typename Backing = HeapBacking>
+class MemoryPool : private PoolCounters<StatsPolicy::enabled> {
 private:
     // Aligned memory block for cache efficiency
     struct Block {
         alignas(64) char data[sizeof(T) * BlockSize];  // 64-byte cache line alignment
         Block* next;
     };
-    
+
+    struct BlockDeleter {
+        void operator()(Block* block) const {
+            Backing::deallocate(block, sizeof(Block), alignof(Block));
+        }
+    };
+
+    // Intrusive free list: a freed object's own storage holds the pointer
+    // to the next free slot, so the free path is two pointer stores with
+    // zero auxiliary memory — no vector that can reallocate mid-session
+    struct FreeSlot {
+        FreeSlot* next;
+    };
+    static_assert(sizeof(T) >= sizeof(FreeSlot),
+                  "pooled type too small to carry the intrusive free link");
+
     Block* head_block;
-    std::vector<std::unique_ptr<Block>> blocks;
-    std::vector<T*> free_list;
+    std::vector<std::unique_ptr<Block, BlockDeleter>> blocks;
+    FreeSlot* free_head;
+    size_t free_count;
     size_t current_index;
-    
-    // Statistics
-    size_t total_allocations = 0;
-    size_t total_deallocations = 0;
-    size_t blocks_allocated = 0;
-    
+
 public:
-    MemoryPool() : head_block(nullptr), current_index(BlockSize) {
+    MemoryPool() : head_block(nullptr), free_head(nullptr), free_count(0),
+                   current_index(BlockSize) {
         // Pre-allocate first block
         allocate_block();
-        
-        // Reserve space for free list to avoid reallocation
-        free_list.reserve(BlockSize);
     }
-    
+
     ~MemoryPool() = default;
-    
-    // Fast allocation with minimal branching
+
+    // Acquire raw storage for one T; construct() adds the placement-new
     [[nodiscard]] inline T* allocate() {
-        ++total_allocations;
-        
-        // Fast path: reuse from free list
-        if (!free_list.empty()) {
-            T* ptr = free_list.back();
-            free_list.pop_back();
-            return ptr;
+        if constexpr (StatsPolicy::enabled) {
+            ++this->total_allocations;
         }
-        
-        // Need new allocation
-        if (current_index >= BlockSize) {
+
+        // Fast path: reuse from free list (cold only during warm-up, before
+        // the first cancels seed it)
+        if (OB_LIKELY(free_head != nullptr)) {
+            FreeSlot* slot = free_head;
+            free_head = slot->next;
+            --free_count;
+            return reinterpret_cast<T*>(slot);
+        }
+
+        // Need new allocation; block exhaustion is once per BlockSize allocs
+        if (OB_UNLIKELY(current_index >= BlockSize)) {
             allocate_block();
         }
-        
+
         return reinterpret_cast<T*>(&head_block->data[sizeof(T) * current_index++]);
     }
-    
-    // Fast deallocation
+
+    // Release raw storage; destroy() is the matching end-of-life call for
+    // objects built with construct()
     inline void deallocate(T* ptr) {
         if (ptr) {
-            ++total_deallocations;
+            if constexpr (StatsPolicy::enabled) {
+                ++this->total_deallocations;
+            }
+            auto* slot = reinterpret_cast<FreeSlot*>(ptr);
+            slot->next = free_head;
+            free_head = slot;
+            ++free_count;
+        }
+    }
+
+    using value_type = T;
+
+    // Object-lifetime pair: the pool owns both ends, so callers never mix
+    // placement-new with a destroying deallocate
+    template<typename... Args>
+    [[nodiscard]] inline T* construct(Args&&... args) {
+        return new (allocate()) T(std::forward<Args>(args)...);
+    }
+
+    // Owned variant of construct(): the handle returns the object to this
+    // pool when it dies, release() hands the raw pointer to a structure
+    // that takes over ownership (defined below PoolPtr)
+    template<typename... Args>
+    [[nodiscard]] inline PoolPtr<MemoryPool> acquire(Args&&... args);
+
+    inline void destroy(T* ptr) {
+        if (ptr) {
             ptr->~T();
-            free_list.push_back(ptr);
+            deallocate(ptr);
         }
     }
-    
+
+    // Warm-up: pre-allocate and touch enough blocks that the next `objects`
+    // allocations are served without a block allocation or a page fault.
+    // New blocks go straight onto the free list (fully zeroed, which faults
+    // every page in), so the first session allocations hit the same fast
+    // path as steady state. Call before go-live, never on the hot path.
+    void reserve(size_t objects) {
+        size_t available = free_count + (BlockSize - current_index);
+        while (available < objects) {
+            allocate_block();
+            std::memset(head_block->data, 0, sizeof(head_block->data));
+            for (size_t i = 0; i < BlockSize; ++i) {
+                auto* slot = reinterpret_cast<FreeSlot*>(&head_block->data[sizeof(T) * i]);
+                slot->next = free_head;
+                free_head = slot;
+            }
+            free_count += BlockSize;
+            current_index = BlockSize;   // whole block handed to the free list
+            available += BlockSize;
+        }
+    }
+
+    [[nodiscard]] size_t free_objects() const { return free_count; }
+
     // Get pool statistics
     void print_stats() const {
         std::cout << "Memory Pool Stats:\n";
-        std::cout << "  Blocks: " << blocks_allocated << "\n";
-        std::cout << "  Total Allocations: " << total_allocations << "\n";
-        std::cout << "  Total Deallocations: " << total_deallocations << "\n";
-        std::cout << "  Active Objects: " << (total_allocations - total_deallocations) << "\n";
-        std::cout << "  Free List Size: " << free_list.size() << "\n";
+        if constexpr (StatsPolicy::enabled) {
+            std::cout << "  Blocks: " << this->blocks_allocated << "\n";
+            std::cout << "  Total Allocations: " << this->total_allocations << "\n";
+            std::cout << "  Total Deallocations: " << this->total_deallocations << "\n";
+            std::cout << "  Active Objects: "
+                      << (this->total_allocations - this->total_deallocations) << "\n";
+        } else {
+            std::cout << "  (counters compiled out)\n";
+        }
+        std::cout << "  Free List Size: " << free_count << "\n";
     }
     
 private:
     void allocate_block() {
-        auto new_block = std::make_unique<Block>();
+        void* raw = Backing::allocate(sizeof(Block), alignof(Block));
+        auto new_block = std::unique_ptr<Block, BlockDeleter>(new (raw) Block);
         new_block->next = head_block;
         head_block = new_block.get();
         blocks.push_back(std::move(new_block));
         current_index = 0;
-        ++blocks_allocated;
+        if constexpr (StatsPolicy::enabled) {
+            ++this->blocks_allocated;
+        }
+    }
+};
+
+// Unique-ownership handle with unique_ptr ergonomics that returns to its
+// MemoryPool instead of the heap on destruction. shared_ptr is ruled out on
+// this path (atomic refcount traffic plus a control-block allocation per
+// handle — see L10/sharedPtrMore.cpp); a PoolPtr is two raw pointers, moves
+// for free, and the move support in the Fifo queues lets it ride a ring
+// without the payload ever being copied or leaked. Typical book usage:
+// acquire() covers the window between pool construction and handoff into an
+// intrusive structure, then release() transfers ownership to the structure.
+template<typename Pool>
+class PoolPtr {
+public:
+    using element_type = typename Pool::value_type;
+
+    PoolPtr() noexcept = default;
+    PoolPtr(Pool& pool, element_type* ptr) noexcept : pool_(&pool), ptr_(ptr) {}
+
+    PoolPtr(PoolPtr&& other) noexcept : pool_(other.pool_), ptr_(other.ptr_) {
+        other.ptr_ = nullptr;
+    }
+    PoolPtr& operator=(PoolPtr&& other) noexcept {
+        if (this != &other) {
+            reset();
+            pool_ = other.pool_;
+            ptr_ = other.ptr_;
+            other.ptr_ = nullptr;
+        }
+        return *this;
+    }
+
+    PoolPtr(const PoolPtr&) = delete;
+    PoolPtr& operator=(const PoolPtr&) = delete;
+
+    ~PoolPtr() { reset(); }
+
+    [[nodiscard]] element_type* get() const noexcept { return ptr_; }
+    element_type* operator->() const noexcept { return ptr_; }
+    element_type& operator*() const noexcept { return *ptr_; }
+    explicit operator bool() const noexcept { return ptr_ != nullptr; }
+
+    // Hand the raw pointer to a structure that takes over ownership
+    [[nodiscard]] element_type* release() noexcept {
+        element_type* p = ptr_;
+        ptr_ = nullptr;
+        return p;
+    }
+
+    // Destroy the held object and return its slot to the pool
+    void reset() noexcept {
+        if (ptr_) {
+            pool_->destroy(ptr_);
+            ptr_ = nullptr;
+        }
+    }
+
+private:
+    Pool* pool_ = nullptr;
+    element_type* ptr_ = nullptr;
+};
+
+template<typename T, size_t BlockSize, typename StatsPolicy, typename Backing>
+template<typename... Args>
+inline PoolPtr<MemoryPool<T, BlockSize, StatsPolicy, Backing>>
+MemoryPool<T, BlockSize, StatsPolicy, Backing>::acquire(Args&&... args) {
+    return PoolPtr<MemoryPool>(*this, construct(std::forward<Args>(args)...));
+}
+
+// Thread-aware sibling of MemoryPool: MemoryPool's free list is single-
+// threaded, so pooled objects cannot cross threads without a global lock. Here
+// each thread keeps its own free-list cache; when a cache overflows, a batch
+// of freed objects is handed back to the owning pool through a lock-free
+// Treiber stack (the next pointer lives inside the freed slot itself), and a
+// thread with an empty cache grabs the whole stack in one exchange. The
+// single-threaded fast path - pop/push on a local vector - is unchanged.
+template<typename T, size_t BlockSize = 4096, size_t TransferBatch = 64>
+class ThreadedMemoryPool {
+private:
+    static constexpr size_t MAX_THREADS = 32;
+
+    // Freed slots are reused as linked-list nodes on the transfer stack
+    struct FreeNode {
+        FreeNode* next;
+    };
+    static_assert(sizeof(T) >= sizeof(FreeNode), "T too small to carry a free-list link");
+
+    // Aligned memory block for cache efficiency (same layout as MemoryPool)
+    struct Block {
+        alignas(64) char data[sizeof(T) * BlockSize];
+    };
+
+    // Per-thread free-list cache, padded so caches never share a cache line
+    struct alignas(64) LocalCache {
+        std::vector<T*> free_list;
+    };
+
+    std::vector<std::unique_ptr<Block>> blocks;
+    size_t current_index = BlockSize;
+    std::atomic_flag block_lock = ATOMIC_FLAG_INIT;   // guards block carving only
+
+    std::atomic<FreeNode*> transfer_stack{nullptr};   // freed objects in flight
+    LocalCache local_[MAX_THREADS];
+
+    // Dense per-pool thread index; threads register on first touch. Wrapping
+    // past MAX_THREADS would silently alias two threads onto one LocalCache,
+    // so over-subscription is a hard error (same cap policy as the hazard
+    // pointer registry in lockFreeWaitFree/hazardPointerList.cpp).
+    int thread_index() const {
+        static std::atomic<int> counter{0};
+        thread_local int index = counter.fetch_add(1);
+        assert(index < static_cast<int>(MAX_THREADS) &&
+               "ThreadedMemoryPool: more than MAX_THREADS threads registered");
+        return index;
+    }
+
+public:
+    ThreadedMemoryPool() = default;
+
+    ThreadedMemoryPool(const ThreadedMemoryPool&) = delete;
+    ThreadedMemoryPool& operator=(const ThreadedMemoryPool&) = delete;
+
+    [[nodiscard]] T* allocate() {
+        LocalCache& cache = local_[thread_index()];
+
+        // Fast path: thread-local free list, no atomics
+        if (!cache.free_list.empty()) {
+            T* ptr = cache.free_list.back();
+            cache.free_list.pop_back();
+            return ptr;
+        }
+
+        // Refill: take the whole transfer stack in one exchange
+        FreeNode* node = transfer_stack.exchange(nullptr, std::memory_order_acquire);
+        if (node) {
+            while (node->next) {
+                cache.free_list.push_back(reinterpret_cast<T*>(node));
+                node = node->next;
+            }
+            return reinterpret_cast<T*>(node);
+        }
+
+        // Slow path: carve a batch of fresh slots from the block arena
+        while (block_lock.test_and_set(std::memory_order_acquire)) {}
+        if (current_index >= BlockSize) {
+            blocks.push_back(std::make_unique<Block>());
+            current_index = 0;
+        }
+        char* base = blocks.back()->data;
+        size_t take = std::min(TransferBatch, BlockSize - current_index);
+        size_t first = current_index;
+        current_index += take;
+        block_lock.clear(std::memory_order_release);
+
+        for (size_t i = 1; i < take; ++i) {
+            cache.free_list.push_back(reinterpret_cast<T*>(base + sizeof(T) * (first + i)));
+        }
+        return reinterpret_cast<T*>(base + sizeof(T) * first);
+    }
+
+    void deallocate(T* ptr) {
+        if (!ptr) {
+            return;
+        }
+        ptr->~T();
+
+        LocalCache& cache = local_[thread_index()];
+        cache.free_list.push_back(ptr);
+
+        // Periodic batch transfer back to the owning pool: keep one batch
+        // locally, push the overflow batch onto the lock-free stack
+        if (cache.free_list.size() >= 2 * TransferBatch) {
+            FreeNode* chain_head = nullptr;
+            for (size_t i = 0; i < TransferBatch; ++i) {
+                FreeNode* n = reinterpret_cast<FreeNode*>(cache.free_list.back());
+                cache.free_list.pop_back();
+                n->next = chain_head;
+                chain_head = n;
+            }
+
+            // Treiber push of the whole chain
+            FreeNode* chain_tail = chain_head;
+            while (chain_tail->next) {
+                chain_tail = chain_tail->next;
+            }
+            FreeNode* old_head = transfer_stack.load(std::memory_order_relaxed);
+            do {
+                chain_tail->next = old_head;
+            } while (!transfer_stack.compare_exchange_weak(old_head, chain_head,
+                                                           std::memory_order_release,
+                                                           std::memory_order_relaxed));
+        }
     }
 };
 
 // ======================== INTERNAL ORDER REPRESENTATION ========================
 
-// Order node with embedded list iterator for O(1) removal
+// Order node with intrusive queue links for O(1) removal. The prev/next
+// pointers live inside the node itself, so queueing an order at a level
+// allocates nothing: std::list would heap-allocate a list node per order.
 struct OrderNode {
     Order order;
-    std::list<OrderNode*>::iterator level_iterator;
-    double original_price;  // For tracking price changes
-    
-    OrderNode(const Order& o) : order(o), original_price(o.price) {}
+    OrderNode* prev;       // Intrusive FIFO links within the level
+    OrderNode* next;
+    Price price;           // Tick price the node is keyed on
+
+    OrderNode(const Order& o, Price p)
+        : order(o), prev(nullptr), next(nullptr), price(p) {}
 };
+// Order (40) + two links (16) + tick price (8) is exactly one cache line;
+// a cancel unlink touches one line per node
+static_assert(sizeof(OrderNode) == 64, "OrderNode no longer fits one cache line");
+static_assert(alignof(OrderNode) == 8, "OrderNode alignment changed");
 
-// Price level with FIFO order queue
+// Price level with intrusive FIFO order queue (head = oldest order)
 struct Level {
-    double price;
+    Price price;
     uint64_t total_quantity;
-    std::list<OrderNode*> orders;  // FIFO queue
+    OrderNode* head;                // Front of the FIFO queue
+    OrderNode* tail;                // Back of the FIFO queue
     uint64_t order_count;           // Track number of orders at this level
+
+    Level(Price p = Price{0})
+        : price(p), total_quantity(0), head(nullptr), tail(nullptr), order_count(0) {}
     
-    Level(double p = 0.0) : price(p), total_quantity(0), order_count(0) {}
-    
-    // Add order to level
+    // Add order to back of level queue
     inline void add_order(OrderNode* node) {
-        orders.push_back(node);
-        node->level_iterator = std::prev(orders.end());
+        node->prev = tail;
+        node->next = nullptr;
+        if (tail) {
+            tail->next = node;
+        } else {
+            head = node;
+        }
+        tail = node;
         total_quantity += node->order.quantity;
         ++order_count;
     }
     
-    // Remove order from level
+    // Unlink order from level queue
     inline void remove_order(OrderNode* node) {
-        orders.erase(node->level_iterator);
+        if (node->prev) {
+            node->prev->next = node->next;
+        } else {
+            head = node->next;
+        }
+        if (node->next) {
+            node->next->prev = node->prev;
+        } else {
+            tail = node->prev;
+        }
+        node->prev = nullptr;
+        node->next = nullptr;
         total_quantity -= node->order.quantity;
         --order_count;
     }
@@ -159,153 +649,611 @@ struct Level {
     }
     
     [[nodiscard]] inline bool is_empty() const {
-        return orders.empty();
+        return head == nullptr;
     }
 };
+static_assert(sizeof(Level) == 40, "Level layout changed");
 
-// ======================== ORDER BOOK IMPLEMENTATION ========================
+// ======================== ORDER ID MAP ========================
+
+// Open-addressing order_id -> OrderNode* map replacing std::unordered_map on
+// the hottest lookup in the book. Linear probing over flat 16-byte slots
+// keeps a probe sequence inside one or two cache lines, where the node-based
+// unordered_map takes a pointer chase per bucket. Capacity is a power of two
+// (mask instead of modulo) and deletion backward-shifts the cluster, so
+// there are no tombstones to degrade probes over a trading day of churn.
+class OrderIdMap {
+    struct Slot {
+        uint64_t key;      // 0 = empty (id 0 handled out of band)
+        OrderNode* value;
+    };
+    static_assert(sizeof(Slot) == 16, "probe stride must stay two slots per cache line");
+
+    static constexpr double MAX_LOAD = 0.7;
+
+public:
+    explicit OrderIdMap(size_t expected = 16) {
+        rehash(capacity_for(expected));
+    }
+
+    // Size the table for `expected` entries; never shrinks
+    void reserve(size_t expected) {
+        size_t needed = capacity_for(expected);
+        if (needed > slots_.size()) {
+            rehash(needed);
+        }
+    }
+
+    [[nodiscard]] size_t size() const { return size_; }
+
+    // Returns the mapped node, or nullptr if absent
+    [[nodiscard]] OrderNode* find(uint64_t key) const {
+        if (key == 0) {
+            return zero_value_;
+        }
+        size_t i = home(key);
+        while (slots_[i].key != 0) {
+            if (slots_[i].key == key) {
+                return slots_[i].value;
+            }
+            i = (i + 1) & mask_;
+        }
+        return nullptr;
+    }
+
+    void insert(uint64_t key, OrderNode* value) {
+        if (key == 0) {
+            if (!zero_value_) ++size_;
+            zero_value_ = value;
+            return;
+        }
+        if (size_ + 1 > static_cast<size_t>(slots_.size() * MAX_LOAD)) {
+            rehash(slots_.size() * 2);
+        }
+        size_t i = home(key);
+        while (slots_[i].key != 0) {
+            if (slots_[i].key == key) {
+                slots_[i].value = value;
+                return;
+            }
+            i = (i + 1) & mask_;
+        }
+        slots_[i] = Slot{key, value};
+        ++size_;
+    }
+
+    // Backward-shift deletion: slide the rest of the probe cluster down over
+    // the hole so lookups never need tombstones
+    bool erase(uint64_t key) {
+        if (key == 0) {
+            if (!zero_value_) return false;
+            zero_value_ = nullptr;
+            --size_;
+            return true;
+        }
+        size_t i = home(key);
+        while (slots_[i].key != key) {
+            if (slots_[i].key == 0) {
+                return false;
+            }
+            i = (i + 1) & mask_;
+        }
+
+        size_t hole = i;
+        size_t j = (i + 1) & mask_;
+        while (slots_[j].key != 0) {
+            // Move slot j into the hole unless its home position lies
+            // cyclically after the hole (then shifting would break its probe)
+            size_t h = home(slots_[j].key);
+            if (((j - h) & mask_) >= ((j - hole) & mask_)) {
+                slots_[hole] = slots_[j];
+                hole = j;
+            }
+            j = (j + 1) & mask_;
+        }
+        slots_[hole] = Slot{0, nullptr};
+        --size_;
+        return true;
+    }
+
+    // Visit every (key, node) pair; order is unspecified
+    template<typename F>
+    void for_each(F&& f) const {
+        if (zero_value_) {
+            f(uint64_t{0}, zero_value_);
+        }
+        for (const Slot& slot : slots_) {
+            if (slot.key != 0) {
+                f(slot.key, slot.value);
+            }
+        }
+    }
 
-class OrderBook {
 private:
-    // Memory pools for different allocation sizes
-    MemoryPool<OrderNode, 1024> order_pool;       // Orders
-    MemoryPool<Level, 256> level_pool;            // Price levels
-    
-    // Price levels sorted by price
-    // Using custom comparators for optimal sorting
-    std::map<double, Level*, std::greater<double>> bid_levels;  // Highest first
-    std::map<double, Level*, std::less<double>> ask_levels;     // Lowest first
-    
-    // O(1) order lookup with reserve optimization
-    std::unordered_map<uint64_t, OrderNode*> order_lookup;
-    
-    // Performance counters
+    [[nodiscard]] size_t home(uint64_t key) const {
+        // Fibonacci hash: sequential exchange ids would otherwise all probe
+        // from neighbouring slots
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & mask_;
+    }
+
+    static size_t capacity_for(size_t expected) {
+        size_t capacity = 16;
+        while (static_cast<size_t>(capacity * MAX_LOAD) < expected) {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    void rehash(size_t new_capacity) {
+        std::vector<Slot> old = std::move(slots_);
+        slots_.assign(new_capacity, Slot{0, nullptr});
+        mask_ = new_capacity - 1;
+        for (const Slot& slot : old) {
+            if (slot.key != 0) {
+                size_t i = home(slot.key);
+                while (slots_[i].key != 0) {
+                    i = (i + 1) & mask_;
+                }
+                slots_[i] = slot;
+            }
+        }
+    }
+
+    std::vector<Slot> slots_;
+    size_t mask_ = 0;
+    size_t size_ = 0;
+    OrderNode* zero_value_ = nullptr;  // order_id 0, kept off the probe array
+};
+
+// ======================== DELTA PUBLISHER ========================
+
+// Incremental level update: what changed, not the whole band. Receivers
+// apply Set/Erase to their own top-N copy instead of diffing full
+// snapshots. 24 bytes, trivially copyable — ring-friendly.
+struct LevelDelta {
+    Price price;
+    uint64_t new_quantity;   // 0 on Erase
+    uint8_t is_bid;
+    uint8_t op;              // LevelDelta::Set / Erase
+    uint8_t pad[6];
+
+    static constexpr uint8_t Set = 0;     // level entered band or changed quantity
+    static constexpr uint8_t Erase = 1;   // level left the subscribed band
+};
+static_assert(sizeof(LevelDelta) == 24, "delta layout changed");
+static_assert(std::is_trivially_copyable_v<LevelDelta>, "delta must be POD");
+
+// SPSC fan-out of book mutations within the subscribed depth. The book
+// thread produces, one downstream consumer (publisher socket, strategy,
+// recorder) drains. Emission sites are the depth-cache maintenance
+// functions, which already know whether a price is in band — so the book
+// pays one branch per mutation when no publisher is attached, and one ring
+// push when one is. The ring never blocks the book: overflow drops the
+// delta and bumps a counter, and the consumer is expected to resync from a
+// snapshot when it sees the drop count move.
+class DeltaPublisher {
+public:
+    explicit DeltaPublisher(size_t ring_capacity = 1 << 14)
+        : ring_(ring_capacity) {}
+
+    // Book-thread side
+    inline void emit(Price price, uint64_t new_quantity, bool is_bid, uint8_t op) {
+        if (OB_UNLIKELY(!ring_.push(
+                LevelDelta{price, new_quantity,
+                           static_cast<uint8_t>(is_bid ? 1 : 0), op, {}}))) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Consumer side
+    [[nodiscard]] bool poll(LevelDelta& out) { return ring_.pop(out); }
+    size_t poll_n(LevelDelta* out, size_t max) { return ring_.pop_n(out, max); }
+
+    [[nodiscard]] uint64_t dropped() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+private:
+    Fifo4<LevelDelta> ring_;
+    std::atomic<uint64_t> dropped_{0};
+};
+
+// ======================== ORDER BOOK IMPLEMENTATION ========================
+
+// Operation counters and latency histograms for the book; the disabled
+// specialization is empty, so maximum-speed builds carry no counter stores
+template<bool Enabled>
+struct BookCounters {
     mutable uint64_t total_orders = 0;
     mutable uint64_t total_cancels = 0;
     mutable uint64_t total_amends = 0;
     mutable uint64_t total_snapshots = 0;
+    mutable LatencyHistogram add_latency;
+    mutable LatencyHistogram cancel_latency;
+    mutable LatencyHistogram amend_latency;
+    mutable LatencyHistogram snapshot_latency;
+};
+template<>
+struct BookCounters<false> {};
+
+// The pools backing one or more books. A book owns a private set by
+// default; a manager running thousands of symbols hands every book the same
+// shared set so a quiet symbol's free list feeds a busy one instead of each
+// book pre-allocating its own blocks.
+template<typename StatsPolicy = DefaultStats>
+struct BookPools {
+    using OrderPool = MemoryPool<OrderNode, 1024, StatsPolicy>;
+    using LevelPool = MemoryPool<Level, 256, StatsPolicy>;
+
+    OrderPool order_pool;       // Orders
+    LevelPool level_pool;       // Price levels
+};
+
+template<typename StatsPolicy = DefaultStats, typename Listener = NullListener>
+class BasicOrderBook : private BookCounters<StatsPolicy::enabled>,
+                       private Listener {   // empty-base: NullListener is free
+private:
+    // Pools: either owned by this book or shared across books via a manager
+    std::unique_ptr<BookPools<StatsPolicy>> owned_pools_;
+    BookPools<StatsPolicy>* pools_;
+    
+    // Per-symbol tick size; doubles are converted to ticks once on entry
+    double tick_size_;
+
+    // Price levels sorted by tick price
+    // Using custom comparators for optimal sorting
+    std::map<Price, Level*, std::greater<Price>> bid_levels;  // Highest first
+    std::map<Price, Level*, std::less<Price>> ask_levels;     // Lowest first
+    
+    // O(1) order lookup: flat open-addressing table (see OrderIdMap above)
+    OrderIdMap order_lookup;
     
     // Cache for best prices
     mutable double cached_best_bid = 0.0;
     mutable double cached_best_ask = 0.0;
     mutable bool cache_valid = false;
-    
+
+    // Incremental top-of-book depth cache: the best cache_depth_ levels per
+    // side, kept sorted best-first and patched on every mutation. Mutations
+    // at prices outside the band cost one compare; a snapshot within the band
+    // is a straight copy instead of a map walk.
+    size_t cache_depth_;
+    std::vector<PriceLevel> bid_cache_;
+    std::vector<PriceLevel> ask_cache_;
+
+    // Reused scratch for apply_batch() add runs; grows once, never shrinks
+    std::vector<Order> add_batch_scratch_;
+
+    // Optional incremental market-data fan-out; nullptr costs one predicted
+    // branch per in-band mutation (see DeltaPublisher above)
+    DeltaPublisher* delta_publisher_ = nullptr;
+
+    // Timestamp helper for the per-operation histograms; only called when
+    // stats are enabled. Calibrated TSC (see timing.cpp): cheap enough that
+    // instrumented builds can stamp every operation instead of sampling.
+    static uint64_t stats_now() {
+        return TscClock::now_ns();
+    }
+
+    MemoryPool<OrderNode, 1024, StatsPolicy>& order_pool() const { return pools_->order_pool; }
+    MemoryPool<Level, 256, StatsPolicy>& level_pool() const { return pools_->level_pool; }
+
 public:
-    OrderBook() {
-        // Pre-allocate hash map buckets for better performance
-        order_lookup.reserve(10000);
+    // expected_orders sizes the lookup table up front; pass the venue's
+    // typical open-order count from config to avoid mid-session rehashes
+    explicit BasicOrderBook(double tick_size = 0.01, size_t depth_cache = 10,
+                            size_t expected_orders = 10000)
+        : owned_pools_(std::make_unique<BookPools<StatsPolicy>>()),
+          pools_(owned_pools_.get()),
+          tick_size_(tick_size),
+          order_lookup(expected_orders),
+          cache_depth_(depth_cache) {
+        bid_cache_.reserve(cache_depth_ + 1);
+        ask_cache_.reserve(cache_depth_ + 1);
+    }
+
+    // Book backed by externally shared pools (see OrderBookManager)
+    BasicOrderBook(BookPools<StatsPolicy>& shared_pools, double tick_size = 0.01,
+                   size_t depth_cache = 10, size_t expected_orders = 10000)
+        : pools_(&shared_pools),
+          tick_size_(tick_size),
+          order_lookup(expected_orders),
+          cache_depth_(depth_cache) {
+        bid_cache_.reserve(cache_depth_ + 1);
+        ask_cache_.reserve(cache_depth_ + 1);
+    }
+
+    BasicOrderBook(BasicOrderBook&&) = default;
+    BasicOrderBook& operator=(BasicOrderBook&&) = default;
+
+    // Deterministic warm-up before go-live: pre-allocate and touch every
+    // pool block the session will need and size the lookup table for the
+    // real resident-order count, so the first packets at the open never pay
+    // a make_unique, a page fault, or a mid-session rehash. The level maps
+    // still grow node by node (std::map cannot be pre-sized); replaying a
+    // priming journal (JournalReplayer::prime in journal.cpp) into a
+    // scratch book on shared pools covers that plus branch/icache heat.
+    void warm_up(size_t expected_orders, size_t expected_levels) {
+        order_pool().reserve(expected_orders);
+        level_pool().reserve(expected_levels);
+        order_lookup.reserve(expected_orders);
+    }
+
+    // Attach/detach incremental market-data fan-out. Deltas are emitted
+    // only for changes within the top cache_depth_ levels (the subscribed
+    // band); the publisher must outlive the book or be detached first.
+    void set_delta_publisher(DeltaPublisher* publisher) {
+        delta_publisher_ = publisher;
+    }
+
+    // The listener base object, for configuring a stateful listener (wiring
+    // an output ring, a journal fd, risk limits) after construction
+    [[nodiscard]] Listener& listener() noexcept { return *this; }
+    [[nodiscard]] const Listener& listener() const noexcept { return *this; }
+
+    // Convert between the external double representation and tick prices
+    [[nodiscard]] Price to_price(double value) const {
+        return Price{static_cast<int64_t>(std::llround(value / tick_size_))};
+    }
+    [[nodiscard]] double to_double(Price price) const {
+        return static_cast<double>(price.ticks) * tick_size_;
     }
     
-    ~OrderBook() {
+    ~BasicOrderBook() {
         // Clean up all orders
-        for (auto& [id, node] : order_lookup) {
-            order_pool.deallocate(node);
-        }
+        order_lookup.for_each([this](uint64_t, OrderNode* node) {
+            order_pool().destroy(node);
+        });
         
         // Clean up all levels
         for (auto& [price, level] : bid_levels) {
-            level_pool.deallocate(level);
+            level_pool().destroy(level);
         }
         for (auto& [price, level] : ask_levels) {
-            level_pool.deallocate(level);
+            level_pool().destroy(level);
         }
     }
     
     // Insert a new order into the book
     void add_order(const Order& order) {
-        // Allocate new order node from pool
-        OrderNode* node = order_pool.allocate();
-        new(node) OrderNode(order);
-        
-        // Add to lookup table
-        order_lookup.emplace(order.order_id, node);
+        uint64_t t0 = 0;
+        if constexpr (StatsPolicy::enabled) {
+            t0 = stats_now();
+        }
+
+        // Allocate new order node; the handle covers the window until the
+        // lookup owns the node (a rehash failure here used to leak it)
+        auto handle = order_pool().acquire(order, to_price(order.price));
+        OrderNode* node = handle.get();
+
+        // Add to lookup table, then hand ownership to the book
+        order_lookup.insert(order.order_id, node);
+        (void)handle.release();
         
         // Invalidate cache
         cache_valid = false;
         
         // Add to appropriate side
         if (order.is_buy) {
-            add_to_side(bid_levels, node);
+            add_to_side(bid_levels, bid_cache_, true, node);
         } else {
-            add_to_side(ask_levels, node);
+            add_to_side(ask_levels, ask_cache_, false, node);
+        }
+
+        listener().on_add(node->order);
+
+        if constexpr (StatsPolicy::enabled) {
+            ++this->total_orders;
+            this->add_latency.record(stats_now() - t0);
+        }
+    }
+
+    // Insert a span of orders with batch-amortized bookkeeping: one
+    // order_lookup rehash check and one best-price cache invalidation for the
+    // whole span, and one level find per run of same-priced orders. Feed
+    // bursts cluster around the touch, so run reuse removes most map finds.
+    void add_orders(const Order* orders, size_t count) {
+        if (count == 0) return;
+        uint64_t t0 = 0;
+        if constexpr (StatsPolicy::enabled) {
+            t0 = stats_now();
+        }
+
+        order_lookup.reserve(order_lookup.size() + count);
+        cache_valid = false;
+
+        Level* run_level = nullptr;
+        Price run_price{0};
+        bool run_is_buy = false;
+
+        for (size_t i = 0; i < count; ++i) {
+            const Order& order = orders[i];
+            auto handle = order_pool().acquire(order, to_price(order.price));
+            OrderNode* node = handle.get();
+            order_lookup.insert(order.order_id, node);
+            (void)handle.release();
+
+            if (run_level && node->price == run_price && order.is_buy == run_is_buy) {
+                run_level->add_order(node);
+                cache_set_quantity(order.is_buy ? bid_cache_ : ask_cache_, run_level);
+            } else if (order.is_buy) {
+                run_level = add_to_side(bid_levels, bid_cache_, true, node);
+                run_price = node->price;
+                run_is_buy = true;
+            } else {
+                run_level = add_to_side(ask_levels, ask_cache_, false, node);
+                run_price = node->price;
+                run_is_buy = false;
+            }
+            listener().on_add(node->order);
+        }
+
+        if constexpr (StatsPolicy::enabled) {
+            this->total_orders += count;
+            this->add_latency.record((stats_now() - t0) / count);
         }
-        
-        ++total_orders;
     }
-    
+
+    // Apply a span of decoded feed events. Adds within the span go through
+    // the run-grouped path above; cancels and amends dispatch individually.
+    // Return value is the number of events that applied cleanly.
+    size_t apply_batch(const BookUpdate* updates, size_t count) {
+        size_t applied = 0;
+        size_t i = 0;
+        while (i < count) {
+            if (updates[i].op == BookUpdate::Op::Add) {
+                // Consume the whole contiguous run of adds in one call
+                size_t j = i;
+                while (j < count && updates[j].op == BookUpdate::Op::Add) ++j;
+                if (j - i == 1) {
+                    add_order(updates[i].order);
+                } else {
+                    add_batch_scratch_.clear();
+                    for (size_t k = i; k < j; ++k) {
+                        add_batch_scratch_.push_back(updates[k].order);
+                    }
+                    add_orders(add_batch_scratch_.data(), add_batch_scratch_.size());
+                }
+                applied += j - i;
+                i = j;
+            } else if (updates[i].op == BookUpdate::Op::Cancel) {
+                applied += cancel_order(updates[i].order.order_id) ? 1 : 0;
+                ++i;
+            } else {
+                applied += amend_order(updates[i].order.order_id,
+                                       updates[i].order.price,
+                                       updates[i].order.quantity) ? 1 : 0;
+                ++i;
+            }
+        }
+        return applied;
+    }
+
     // Cancel an existing order by its ID
     [[nodiscard]] bool cancel_order(uint64_t order_id) {
-        auto it = order_lookup.find(order_id);
-        if (it == order_lookup.end()) {
+        uint64_t t0 = 0;
+        if constexpr (StatsPolicy::enabled) {
+            t0 = stats_now();
+        }
+
+        OrderNode* node = order_lookup.find(order_id);
+        // Replay shows cancels for unknown ids are rare (already-filled races)
+        if (OB_UNLIKELY(!node)) {
             return false;
         }
-        
-        OrderNode* node = it->second;
-        
+
         // Invalidate cache
         cache_valid = false;
-        
+
+        // The handle owns the node from here; every exit path below returns
+        // it to the pool
+        PoolPtr<typename BookPools<StatsPolicy>::OrderPool> dead(order_pool(), node);
+
         // Remove from appropriate side
         if (node->order.is_buy) {
-            remove_from_side(bid_levels, node);
+            remove_from_side(bid_levels, bid_cache_, node);
         } else {
-            remove_from_side(ask_levels, node);
+            remove_from_side(ask_levels, ask_cache_, node);
         }
+
+        listener().on_cancel(node->order);
+
+        // Remove from lookup; `dead` frees the node at scope exit
+        order_lookup.erase(order_id);
+        dead.reset();
         
-        // Remove from lookup and deallocate
-        order_lookup.erase(it);
-        order_pool.deallocate(node);
-        
-        ++total_cancels;
+        if constexpr (StatsPolicy::enabled) {
+            ++this->total_cancels;
+            this->cancel_latency.record(stats_now() - t0);
+        }
         return true;
     }
     
     // Amend an existing order's price or quantity
     [[nodiscard]] bool amend_order(uint64_t order_id, double new_price, uint64_t new_quantity) {
-        auto it = order_lookup.find(order_id);
-        if (it == order_lookup.end()) {
+        uint64_t t0 = 0;
+        if constexpr (StatsPolicy::enabled) {
+            t0 = stats_now();
+        }
+
+        OrderNode* node = order_lookup.find(order_id);
+        if (OB_UNLIKELY(!node)) {
             return false;
         }
-        
-        OrderNode* node = it->second;
-        
+
         // Invalidate cache
         cache_valid = false;
-        
-        // Check if price changes (using epsilon for floating point comparison)
-        constexpr double epsilon = 1e-9;
-        if (std::abs(node->order.price - new_price) > epsilon) {
-            // Price change: cancel and re-add to maintain FIFO
-            Order new_order = node->order;
-            new_order.price = new_price;
-            new_order.quantity = new_quantity;
-            new_order.timestamp_ns = std::chrono::high_resolution_clock::now().time_since_epoch().count();
-            
-            cancel_order(order_id);
-            add_order(new_order);
+
+        // Check if price changes (exact integer compare on ticks)
+        Price new_ticks = to_price(new_price);
+        if (node->price != new_ticks) {
+            // Price change: relocate the existing node between levels. The
+            // old path was cancel_order + add_order — two lookup operations,
+            // a pool round-trip and a placement-new for what is logically
+            // "move this node". Unlinking and relinking preserves the
+            // lookup entry and the pool slot; FIFO fairness is kept because
+            // the node joins the back of the destination level's queue.
+            if (node->order.is_buy) {
+                remove_from_side(bid_levels, bid_cache_, node);
+            } else {
+                remove_from_side(ask_levels, ask_cache_, node);
+            }
+
+            node->price = new_ticks;
+            node->order.price = new_price;
+            node->order.quantity = new_quantity;
+            node->order.timestamp_ns = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+
+            if (node->order.is_buy) {
+                add_to_side(bid_levels, bid_cache_, true, node);
+            } else {
+                add_to_side(ask_levels, ask_cache_, false, node);
+            }
         } else {
             // Quantity-only change: update in place
             if (node->order.is_buy) {
-                update_quantity_in_place(bid_levels, node, new_quantity);
+                update_quantity_in_place(bid_levels, bid_cache_, node, new_quantity);
             } else {
-                update_quantity_in_place(ask_levels, node, new_quantity);
+                update_quantity_in_place(ask_levels, ask_cache_, node, new_quantity);
             }
         }
         
-        ++total_amends;
+        listener().on_amend(node->order);
+
+        if constexpr (StatsPolicy::enabled) {
+            ++this->total_amends;
+            this->amend_latency.record(stats_now() - t0);
+        }
         return true;
     }
     
     // Get a snapshot of top N bid and ask levels (optimized version)
     void get_snapshot(size_t depth, std::vector<PriceLevel>& bids, std::vector<PriceLevel>& asks) const {
-        ++total_snapshots;
+        uint64_t t0 = 0;
+        if constexpr (StatsPolicy::enabled) {
+            ++this->total_snapshots;
+            t0 = stats_now();
+        }
         
         // Pre-allocate vectors
         bids.clear();
         asks.clear();
         bids.reserve(depth);
         asks.reserve(depth);
-        
+
+        // Fast path: requested depth fits the incrementally maintained cache,
+        // so the snapshot is a straight copy of two small arrays
+        if (depth <= cache_depth_) {
+            bids.assign(bid_cache_.begin(),
+                        bid_cache_.begin() + std::min(depth, bid_cache_.size()));
+            asks.assign(ask_cache_.begin(),
+                        ask_cache_.begin() + std::min(depth, ask_cache_.size()));
+            if constexpr (StatsPolicy::enabled) {
+                this->snapshot_latency.record(stats_now() - t0);
+            }
+            return;
+        }
+
         // Get top bids
         size_t count = 0;
         for (const auto& [price, level] : bid_levels) {
@@ -319,8 +1267,152 @@ public:
             if (count++ >= depth) break;
             asks.emplace_back(PriceLevel{price, level->total_quantity});
         }
+
+        if constexpr (StatsPolicy::enabled) {
+            this->snapshot_latency.record(stats_now() - t0);
+        }
     }
-    
+
+    // Compile-time-depth snapshot for publishers that always send a fixed
+    // number of levels (5 or 10 in practice). The output is a caller-owned
+    // stack array — no vector, no reserve, no heap — and with Depth a
+    // template constant the copy loops fully unroll. Returns the number of
+    // populated levels per side; entries past the count are untouched.
+    // When Depth exceeds the book's cache band this falls back to a map
+    // walk, so size the book's depth_cache to cover the publisher's depth.
+    template<size_t Depth>
+    void get_snapshot_fixed(std::array<PriceLevel, Depth>& bids, size_t& bid_count,
+                            std::array<PriceLevel, Depth>& asks, size_t& ask_count) const {
+        static_assert(Depth > 0, "snapshot depth must be non-zero");
+        if constexpr (StatsPolicy::enabled) {
+            ++this->total_snapshots;
+        }
+
+        if (Depth <= cache_depth_) {
+            bid_count = std::min(Depth, bid_cache_.size());
+            ask_count = std::min(Depth, ask_cache_.size());
+            for (size_t i = 0; i < Depth; ++i) {       // trip count known: unrolls
+                if (i < bid_count) bids[i] = bid_cache_[i];
+                if (i < ask_count) asks[i] = ask_cache_[i];
+            }
+            return;
+        }
+
+        bid_count = 0;
+        for (const auto& [price, level] : bid_levels) {
+            if (bid_count >= Depth) break;
+            bids[bid_count++] = PriceLevel{price, level->total_quantity};
+        }
+        ask_count = 0;
+        for (const auto& [price, level] : ask_levels) {
+            if (ask_count >= Depth) break;
+            asks[ask_count++] = PriceLevel{price, level->total_quantity};
+        }
+    }
+
+    // Zero-copy traversal of the top `depth` levels of one side, best price
+    // first. The callable is invoked per level directly over the internal
+    // structures — no vector, no clear/reserve churn, nothing copied — and
+    // inlines into fold-style callers (sum depth, find a price). The
+    // visitor takes (Price, uint64_t quantity); returning bool stops the
+    // walk early on false, returning void visits the full depth. Within
+    // the cache band this reads the depth cache; deeper requests walk the
+    // level map.
+    template<typename Visitor>
+    void visit_levels(bool is_bid, size_t depth, Visitor&& visit) const {
+        auto step = [&](Price price, uint64_t quantity) -> bool {
+            if constexpr (std::is_void_v<decltype(visit(price, quantity))>) {
+                visit(price, quantity);
+                return true;
+            } else {
+                return visit(price, quantity);
+            }
+        };
+
+        if (depth <= cache_depth_) {
+            const std::vector<PriceLevel>& cache = is_bid ? bid_cache_ : ask_cache_;
+            size_t n = std::min(depth, cache.size());
+            for (size_t i = 0; i < n; ++i) {
+                if (!step(cache[i].price, cache[i].total_quantity)) return;
+            }
+            return;
+        }
+
+        size_t count = 0;
+        if (is_bid) {
+            for (const auto& [price, level] : bid_levels) {
+                if (count++ >= depth || !step(price, level->total_quantity)) return;
+            }
+        } else {
+            for (const auto& [price, level] : ask_levels) {
+                if (count++ >= depth || !step(price, level->total_quantity)) return;
+            }
+        }
+    }
+
+    // Deterministic full-book traversal: every resting order, bids then
+    // asks, levels best-first, FIFO order within each level. This is the
+    // canonical serialization order — restore_sorted() expects records in
+    // exactly this sequence (see checkpoint.cpp).
+    template<typename Visitor>
+    void for_each_resting_order(Visitor&& visit) const {
+        for (const auto& [price, level] : bid_levels) {
+            for (const OrderNode* n = level->head; n; n = n->next) {
+                visit(n->order);
+            }
+        }
+        for (const auto& [price, level] : ask_levels) {
+            for (const OrderNode* n = level->head; n; n = n->next) {
+                visit(n->order);
+            }
+        }
+    }
+
+    // Bulk restore onto an EMPTY book from records in the exact order
+    // for_each_resting_order emits them. Because each side arrives sorted
+    // best-first, every new level lands at the map's end() and the hinted
+    // emplace builds the tree in O(n) instead of O(n log n); FIFO order
+    // within levels is reproduced by appending. Returns orders restored.
+    size_t restore_sorted(const Order* orders, size_t count) {
+        order_lookup.reserve(count);
+        Level* level = nullptr;
+        Price level_price{0};
+        bool level_is_buy = false;
+
+        for (size_t i = 0; i < count; ++i) {
+            const Order& o = orders[i];
+            Price p = to_price(o.price);
+            auto handle = order_pool().acquire(o, p);
+            OrderNode* node = handle.get();
+
+            if (!level || p != level_price || o.is_buy != level_is_buy) {
+                // A chunked caller may split a level across calls; if the
+                // side's worst level matches, keep appending to it
+                auto open_level = [&](auto& side) -> Level* {
+                    if (!side.empty() && side.rbegin()->first == p) {
+                        return side.rbegin()->second;
+                    }
+                    auto fresh = level_pool().acquire(p);
+                    side.emplace_hint(side.end(), p, fresh.get());
+                    return fresh.release();
+                };
+                level = o.is_buy ? open_level(bid_levels) : open_level(ask_levels);
+                level_price = p;
+                level_is_buy = o.is_buy;
+            }
+            level->add_order(node);
+            order_lookup.insert(o.order_id, node);
+            (void)handle.release();
+        }
+
+        rebuild_depth_caches();
+        cache_valid = false;
+        if constexpr (StatsPolicy::enabled) {
+            this->total_orders += count;
+        }
+        return count;
+    }
+
     // Print current state of the order book
     void print_book(size_t depth = 10) const {
         std::vector<PriceLevel> bids, asks;
@@ -339,13 +1431,13 @@ public:
         std::cout << "├─────────────┼──────────────┤\n";
         
         for (auto it = asks.rbegin(); it != asks.rend(); ++it) {
-            std::cout << "│ " << std::left << std::setw(12) << it->price 
+            std::cout << "│ " << std::left << std::setw(12) << to_double(it->price) 
                       << " │ " << std::right << std::setw(12) << it->total_quantity << " │\n";
         }
         
         // Print spread
         if (!bids.empty() && !asks.empty()) {
-            double spread = asks.front().price - bids.front().price;
+            double spread = to_double(asks.front().price) - to_double(bids.front().price);
             std::cout << "├─────────────┴──────────────┤\n";
             std::cout << "│   SPREAD: " << std::setw(8) << spread 
                       << "          │\n";
@@ -360,7 +1452,7 @@ public:
         std::cout << "├─────────────┼──────────────┤\n";
         
         for (const auto& level : bids) {
-            std::cout << "│ " << std::left << std::setw(12) << level.price 
+            std::cout << "│ " << std::left << std::setw(12) << to_double(level.price) 
                       << " │ " << std::right << std::setw(12) << level.total_quantity << " │\n";
         }
         
@@ -370,19 +1462,55 @@ public:
         std::cout << "  • Active Orders: " << order_lookup.size() << "\n";
         std::cout << "  • Bid Levels: " << bid_levels.size() << "\n";
         std::cout << "  • Ask Levels: " << ask_levels.size() << "\n";
-        std::cout << "  • Total Orders Processed: " << total_orders << "\n";
+        if constexpr (StatsPolicy::enabled) {
+            std::cout << "  • Total Orders Processed: " << this->total_orders << "\n";
+        }
     }
     
     // Get best bid and ask prices with caching
     [[nodiscard]] std::pair<double, double> get_best_prices() const {
         if (!cache_valid) {
-            cached_best_bid = bid_levels.empty() ? 0.0 : bid_levels.begin()->first;
-            cached_best_ask = ask_levels.empty() ? std::numeric_limits<double>::max() : ask_levels.begin()->first;
+            cached_best_bid = bid_levels.empty() ? 0.0 : to_double(bid_levels.begin()->first);
+            cached_best_ask = ask_levels.empty() ? std::numeric_limits<double>::max() : to_double(ask_levels.begin()->first);
             cache_valid = true;
         }
         return {cached_best_bid, cached_best_ask};
     }
     
+    // Submit an order through the matching engine. Crossing quantity fills
+    // against the opposite side's FIFO queues in place (oldest resting order
+    // first); any residual quantity rests in the book. Trade reports go into
+    // the caller-supplied buffer. Returns the number of trades written.
+    //
+    // Truncation contract: if the buffer fills mid-sweep (return value ==
+    // max_trades) with marketable quantity still on the other side, the
+    // residual is NOT rested — resting it would leave a crossed book. The
+    // caller detects this via the return value, computes the unfilled
+    // remainder from the trade quantities, and resubmits it.
+    size_t submit_order(const Order& order, Trade* trades, size_t max_trades) {
+        uint64_t remaining = order.quantity;
+        Price limit = to_price(order.price);
+
+        size_t trade_count = order.is_buy
+            ? match_against(ask_levels, ask_cache_, order, limit, remaining, trades, max_trades)
+            : match_against(bid_levels, bid_cache_, order, limit, remaining, trades, max_trades);
+
+        if (remaining > 0) {
+            // Still marketable means the sweep stopped only because the trade
+            // buffer filled; leave the residual with the caller (see contract)
+            bool still_crossing = order.is_buy
+                ? (!ask_levels.empty() && ask_levels.begin()->first <= limit)
+                : (!bid_levels.empty() && bid_levels.begin()->first >= limit);
+            if (still_crossing) {
+                return trade_count;
+            }
+            Order residual = order;
+            residual.quantity = remaining;
+            add_order(residual);
+        }
+        return trade_count;
+    }
+
     // Check if order book can match (for optional matching implementation)
     [[nodiscard]] bool can_match() const {
         if (bid_levels.empty() || ask_levels.empty()) {
@@ -407,10 +1535,8 @@ public:
     
     [[nodiscard]] Stats get_stats() const {
         auto [best_bid, best_ask] = get_best_prices();
-        return Stats{
-            total_orders,
-            total_cancels,
-            total_amends,
+        Stats stats{
+            0, 0, 0,
             static_cast<uint64_t>(order_lookup.size()),
             bid_levels.size(),
             ask_levels.size(),
@@ -418,6 +1544,29 @@ public:
             best_ask,
             (best_ask == std::numeric_limits<double>::max()) ? 0.0 : best_ask - best_bid
         };
+        if constexpr (StatsPolicy::enabled) {
+            stats.total_orders = this->total_orders;
+            stats.total_cancels = this->total_cancels;
+            stats.total_amends = this->total_amends;
+        }
+        return stats;
+    }
+
+    // Raw latency histograms for exporters (see telemetry.cpp); all null
+    // when stats are compiled out
+    struct HistogramRefs {
+        const LatencyHistogram* add;
+        const LatencyHistogram* cancel;
+        const LatencyHistogram* amend;
+        const LatencyHistogram* snapshot;
+    };
+    [[nodiscard]] HistogramRefs latency_histograms() const {
+        if constexpr (StatsPolicy::enabled) {
+            return {&this->add_latency, &this->cancel_latency,
+                    &this->amend_latency, &this->snapshot_latency};
+        } else {
+            return {nullptr, nullptr, nullptr, nullptr};
+        }
     }
     
     // Print detailed performance statistics
@@ -437,7 +1586,9 @@ public:
         std::cout << "\nBook Structure:\n";
         std::cout << "  • Bid Price Levels: " << stats.bid_levels << "\n";
         std::cout << "  • Ask Price Levels: " << stats.ask_levels << "\n";
-        std::cout << "  • Total Snapshots: " << total_snapshots << "\n";
+        if constexpr (StatsPolicy::enabled) {
+            std::cout << "  • Total Snapshots: " << this->total_snapshots << "\n";
+        }
         
         std::cout << "\nMarket Data:\n";
         std::cout << std::fixed << std::setprecision(2);
@@ -446,54 +1597,253 @@ public:
         std::cout << "  • Spread: " << stats.spread << "\n";
         
         std::cout << "\nMemory Usage:\n";
-        order_pool.print_stats();
+        order_pool().print_stats();
+
+        if constexpr (StatsPolicy::enabled) {
+            std::cout << "\nOperation Latencies:\n";
+            LatencyHistogram::print_header();
+            this->add_latency.print("add_order");
+            this->cancel_latency.print("cancel_order");
+            this->amend_latency.print("amend_order");
+            this->snapshot_latency.print("get_snapshot");
+        }
     }
     
 private:
-    // Optimized add to side with level pooling
+    // --- incremental depth-cache maintenance ---
+
+    static bool better(Price a, Price b, bool is_bid) {
+        return is_bid ? a > b : a < b;
+    }
+
+    // Rebuild both cache bands from the maps (restore path only)
+    void rebuild_depth_caches() {
+        bid_cache_.clear();
+        ask_cache_.clear();
+        size_t count = 0;
+        for (const auto& [price, level] : bid_levels) {
+            if (count++ >= cache_depth_) break;
+            bid_cache_.push_back(PriceLevel{price, level->total_quantity});
+        }
+        count = 0;
+        for (const auto& [price, level] : ask_levels) {
+            if (count++ >= cache_depth_) break;
+            ask_cache_.push_back(PriceLevel{price, level->total_quantity});
+        }
+    }
+
+    // Whether a cache reference is the bid side; lets the delta hooks learn
+    // the side without widening every helper's signature
+    bool is_bid_cache(const std::vector<PriceLevel>& cache) const {
+        return &cache == &bid_cache_;
+    }
+
+    // Patch the cached quantity of a level already in the band; levels
+    // outside the band cost one failed scan of at most cache_depth_ entries
+    void cache_set_quantity(std::vector<PriceLevel>& cache, const Level* level) {
+        for (auto& pl : cache) {
+            if (pl.price == level->price) {
+                pl.total_quantity = level->total_quantity;
+                // In band and already in registers: the cheap place to fan out
+                if (delta_publisher_) {
+                    delta_publisher_->emit(level->price, level->total_quantity,
+                                           is_bid_cache(cache), LevelDelta::Set);
+                }
+                return;
+            }
+        }
+    }
+
+    // Insert (or update) a level in the cache, keeping it sorted best-first
+    // and capped at cache_depth_; out-of-band prices return after one compare
+    void cache_insert(std::vector<PriceLevel>& cache, bool is_bid, const Level* level) {
+        for (auto& pl : cache) {
+            if (pl.price == level->price) {
+                pl.total_quantity = level->total_quantity;
+                if (delta_publisher_) {
+                    delta_publisher_->emit(level->price, level->total_quantity,
+                                           is_bid, LevelDelta::Set);
+                }
+                return;
+            }
+        }
+        if (cache.size() >= cache_depth_ && !better(level->price, cache.back().price, is_bid)) {
+            return;  // outside the top band: free
+        }
+        auto pos = cache.begin();
+        while (pos != cache.end() && better(pos->price, level->price, is_bid)) {
+            ++pos;
+        }
+        cache.insert(pos, PriceLevel{level->price, level->total_quantity});
+        if (delta_publisher_) {
+            delta_publisher_->emit(level->price, level->total_quantity,
+                                   is_bid, LevelDelta::Set);
+        }
+        if (cache.size() > cache_depth_) {
+            // The old worst level just left the subscribed band
+            if (delta_publisher_) {
+                delta_publisher_->emit(cache.back().price, 0, is_bid,
+                                       LevelDelta::Erase);
+            }
+            cache.pop_back();
+        }
+    }
+
+    // Drop a removed level from the cache and backfill the band from the map
+    // (one find + one step, not a full walk). Call after the map erase.
     template<typename MapType>
-    void add_to_side(MapType& side, OrderNode* node) {
-        auto it = side.find(node->order.price);
-        
+    void cache_erase(std::vector<PriceLevel>& cache, MapType& side, Price price) {
+        for (auto it = cache.begin(); it != cache.end(); ++it) {
+            if (it->price == price) {
+                cache.erase(it);
+                if (delta_publisher_) {
+                    delta_publisher_->emit(price, 0, is_bid_cache(cache),
+                                           LevelDelta::Erase);
+                }
+                break;
+            }
+        }
+        if (cache.size() >= cache_depth_) {
+            return;
+        }
+        if (cache.empty()) {
+            if (!side.empty()) {
+                auto mit = side.begin();
+                cache.push_back(PriceLevel{mit->first, mit->second->total_quantity});
+                if (delta_publisher_) {
+                    delta_publisher_->emit(mit->first, mit->second->total_quantity,
+                                           is_bid_cache(cache), LevelDelta::Set);
+                }
+            }
+            return;
+        }
+        auto mit = side.find(cache.back().price);
+        if (mit == side.end()) {
+            return;
+        }
+        ++mit;
+        if (mit != side.end()) {
+            cache.push_back(PriceLevel{mit->first, mit->second->total_quantity});
+            // Backfill entered the band from below
+            if (delta_publisher_) {
+                delta_publisher_->emit(mit->first, mit->second->total_quantity,
+                                       is_bid_cache(cache), LevelDelta::Set);
+            }
+        }
+    }
+
+    // Walk the aggressive side of a cross: fill resting orders in FIFO order,
+    // removing fully-filled nodes and emptied levels back to their pools
+    template<typename MapType>
+    size_t match_against(MapType& side, std::vector<PriceLevel>& cache,
+                         const Order& taker, Price limit,
+                         uint64_t& remaining, Trade* trades, size_t max_trades) {
+        size_t count = 0;
+        while (remaining > 0 && count < max_trades && !side.empty()) {
+            auto it = side.begin();
+            Level* level = it->second;
+
+            // Best opposite level no longer crosses the taker's limit: done
+            bool crosses = taker.is_buy ? (it->first <= limit) : (it->first >= limit);
+            if (!crosses) {
+                break;
+            }
+
+            cache_valid = false;
+            while (remaining > 0 && count < max_trades && level->head) {
+                OrderNode* maker = level->head;
+                uint64_t fill = std::min(remaining, maker->order.quantity);
+                trades[count] = Trade{maker->order.order_id, taker.order_id, level->price, fill};
+                remaining -= fill;
+
+                if (fill == maker->order.quantity) {
+                    level->remove_order(maker);
+                    order_lookup.erase(maker->order.order_id);
+                    order_pool().destroy(maker);
+                } else {
+                    // Partial fill: shrink the resting order in place
+                    level->update_quantity(maker, maker->order.quantity - fill);
+                }
+                listener().on_trade(trades[count]);
+                ++count;
+            }
+
+            if (level->is_empty()) {
+                Price price = level->price;
+                side.erase(it);
+                level_pool().destroy(level);
+                cache_erase(cache, side, price);
+            } else {
+                cache_set_quantity(cache, level);
+            }
+        }
+        return count;
+    }
+
+    // Optimized add to side with level pooling; returns the level so batch
+    // callers can reuse it across a run of same-priced orders
+    template<typename MapType>
+    Level* add_to_side(MapType& side, std::vector<PriceLevel>& cache, bool is_bid, OrderNode* node) {
+        auto it = side.find(node->price);
+
         Level* level;
-        if (it == side.end()) {
-            // Create new level from pool
-            level = level_pool.allocate();
-            new(level) Level(node->order.price);
-            side.emplace(node->order.price, level);
+        // Most adds land on a populated level: a day's flow concentrates on
+        // far fewer prices than orders
+        if (OB_UNLIKELY(it == side.end())) {
+            // Create new level from pool; the handle guards the map emplace
+            auto fresh = level_pool().acquire(node->price);
+            side.emplace(node->price, fresh.get());
+            level = fresh.release();
         } else {
             level = it->second;
         }
-        
+
         level->add_order(node);
+        cache_insert(cache, is_bid, level);
+        return level;
     }
     
     // Optimized remove from side
     template<typename MapType>
-    void remove_from_side(MapType& side, OrderNode* node) {
-        auto it = side.find(node->order.price);
-        if (it != side.end()) {
+    void remove_from_side(MapType& side, std::vector<PriceLevel>& cache, OrderNode* node) {
+        // The unlink will touch the FIFO neighbours; start pulling their
+        // lines while the level map walk runs
+        OB_PREFETCH(node->prev);
+        OB_PREFETCH(node->next);
+        auto it = side.find(node->price);
+        if (OB_LIKELY(it != side.end())) {
             Level* level = it->second;
             level->remove_order(node);
-            
+
             // Remove empty price level and return to pool
             if (level->is_empty()) {
+                Price price = level->price;
                 side.erase(it);
-                level_pool.deallocate(level);
+                level_pool().destroy(level);
+                cache_erase(cache, side, price);
+            } else {
+                cache_set_quantity(cache, level);
             }
         }
     }
     
     // Optimized in-place quantity update
     template<typename MapType>
-    void update_quantity_in_place(MapType& side, OrderNode* node, uint64_t new_quantity) {
-        auto it = side.find(node->order.price);
+    void update_quantity_in_place(MapType& side, std::vector<PriceLevel>& cache,
+                                  OrderNode* node, uint64_t new_quantity) {
+        auto it = side.find(node->price);
         if (it != side.end()) {
             it->second->update_quantity(node, new_quantity);
+            cache_set_quantity(cache, it->second);
         }
     }
 };
 
+// Default book type; DefaultStats follows NDEBUG. Instantiate
+// BasicOrderBook<StatsDisabled> directly for a maximum-speed book in a
+// build that otherwise keeps stats on.
+using OrderBook = BasicOrderBook<>;
+
 // ======================== TEST SUITE ========================
 
 class OrderBookTester {
@@ -553,14 +1903,48 @@ public:
         std::cout << "\n📸 Top 3 Levels Snapshot:\n";
         std::cout << "Bids: ";
         for (const auto& lvl : bids) {
-            std::cout << "[" << lvl.price << ":" << lvl.total_quantity << "] ";
+            std::cout << "[" << book.to_double(lvl.price) << ":" << lvl.total_quantity << "] ";
         }
         std::cout << "\nAsks: ";
         for (const auto& lvl : asks) {
-            std::cout << "[" << lvl.price << ":" << lvl.total_quantity << "] ";
+            std::cout << "[" << book.to_double(lvl.price) << ":" << lvl.total_quantity << "] ";
         }
         std::cout << "\n";
-        
+
+        // Fixed-depth snapshot must agree with the dynamic one
+        std::array<PriceLevel, 3> fbids, fasks;
+        size_t nb = 0, na = 0;
+        book.get_snapshot_fixed<3>(fbids, nb, fasks, na);
+        bool fixed_ok = nb == bids.size() && na == asks.size();
+        for (size_t i = 0; fixed_ok && i < nb; ++i) {
+            fixed_ok = fbids[i].price == bids[i].price &&
+                       fbids[i].total_quantity == bids[i].total_quantity;
+        }
+        for (size_t i = 0; fixed_ok && i < na; ++i) {
+            fixed_ok = fasks[i].price == asks[i].price &&
+                       fasks[i].total_quantity == asks[i].total_quantity;
+        }
+        std::cout << (fixed_ok ? "  ✓ get_snapshot_fixed matches dynamic snapshot\n"
+                               : "  ✗ get_snapshot_fixed MISMATCH\n");
+
+        // Visitor traversal: fold without intermediate storage, plus early
+        // exit when the visitor returns false
+        uint64_t visited_depth = 0;
+        book.visit_levels(true, 3, [&](Price, uint64_t quantity) {
+            visited_depth += quantity;
+        });
+        uint64_t snapshot_depth = 0;
+        for (const auto& lvl : bids) snapshot_depth += lvl.total_quantity;
+
+        size_t levels_seen = 0;
+        book.visit_levels(false, 10, [&](Price price, uint64_t) {
+            ++levels_seen;
+            return price != asks[1].price;   // stop at the second ask level
+        });
+        bool visit_ok = visited_depth == snapshot_depth && levels_seen == 2;
+        std::cout << (visit_ok ? "  ✓ visit_levels folds and early-exits correctly\n"
+                               : "  ✗ visit_levels MISMATCH\n");
+
         book.print_detailed_stats();
     }
     
@@ -664,6 +2048,267 @@ public:
         book.print_detailed_stats();
     }
     
+    // Matching engine test
+    static void run_matching_test() {
+        std::cout << "\n\u2554\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2557\n";
+        std::cout << "\u2551      MATCHING ENGINE TEST       \u2551\n";
+        std::cout << "\u255a\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u2550\u255d\n";
+
+        OrderBook book;
+
+        // Resting liquidity
+        book.add_order({1, false, 100.05, 100, get_timestamp()});
+        book.add_order({2, false, 100.05, 200, get_timestamp()});  // FIFO behind order 1
+        book.add_order({3, false, 100.10, 300, get_timestamp()});
+
+        // Aggressive buy sweeps the first level and part of the second
+        Trade trades[16];
+        size_t n = book.submit_order({100, true, 100.10, 450, get_timestamp()}, trades, 16);
+
+        std::cout << "\nTrades (" << n << "):\n";
+        for (size_t i = 0; i < n; ++i) {
+            std::cout << "  maker=" << trades[i].maker_order_id
+                      << " taker=" << trades[i].taker_order_id
+                      << " px=" << book.to_double(trades[i].price)
+                      << " qty=" << trades[i].quantity << "\n";
+        }
+
+        auto stats = book.get_stats();
+        std::cout << "Active orders after sweep: " << stats.active_orders << "\n";
+
+        // Aggressive order with residual rests in the book
+        n = book.submit_order({101, true, 100.10, 1000, get_timestamp()}, trades, 16);
+        std::cout << "Second sweep trades: " << n
+                  << ", best bid now: " << book.get_best_prices().first << "\n";
+
+        // Truncation contract: fill the trade buffer mid-sweep and verify the
+        // still-crossing residual is held back instead of resting crossed
+        for (uint64_t id = 200; id < 204; ++id) {
+            book.add_order({id, false, 100.20, 100, get_timestamp()});
+        }
+        Trade small[2];
+        n = book.submit_order({300, true, 100.20, 400, get_timestamp()}, small, 2);
+        bool truncated_ok = n == 2 && !book.can_match()
+                         && !book.cancel_order(300);   // residual never rested
+        std::cout << (truncated_ok
+                          ? "✓ Full trade buffer leaves residual with the caller, book uncrossed\n"
+                          : "✗ Truncated sweep mishandled the residual\n");
+    }
+
+    // Hot-path benchmark for the branch-hint/prefetch pass: a realistic
+    // price-clustered add/cancel/amend mix (the flow whose bias the hints
+    // encode). Build once normally and once with -DORDERBOOK_NO_HINTS and
+    // compare the two numbers on the target host.
+    static void run_hot_path_benchmark() {
+        std::cout << "\n╔════════════════════════════════╗\n";
+        std::cout << "║      HOT PATH BENCHMARK         ║\n";
+#ifdef ORDERBOOK_NO_HINTS
+        std::cout << "║   (hints compiled OUT)          ║\n";
+#else
+        std::cout << "║   (hints compiled in)           ║\n";
+#endif
+        std::cout << "╚════════════════════════════════╝\n";
+
+        // StatsDisabled so the timing loop measures the book, not counters
+        BasicOrderBook<StatsDisabled> book;
+        const int num_events = 2000000;
+
+        std::mt19937 gen(42);  // fixed seed: identical flow in both builds
+        std::normal_distribution<> offset_dist(0.0, 5.0);
+        std::uniform_int_distribution<> quantity_dist(100, 1000);
+        std::uniform_int_distribution<> action_dist(0, 99);
+
+        double mid = 100.0;
+        uint64_t next_id = 1;
+        std::vector<uint64_t> live;
+        live.reserve(num_events);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < num_events; ++i) {
+            mid += (gen() % 2 ? 0.01 : -0.01);
+            int action = action_dist(gen);
+            double px = mid + static_cast<int>(offset_dist(gen)) * 0.01;
+
+            if (action < 50 || live.empty()) {
+                book.add_order({next_id, (gen() % 2) == 0, px,
+                                static_cast<uint64_t>(quantity_dist(gen)), 0});
+                live.push_back(next_id++);
+            } else if (action < 85) {
+                size_t k = gen() % live.size();
+                if (book.cancel_order(live[k])) {
+                    live[k] = live.back();
+                    live.pop_back();
+                }
+            } else {
+                size_t k = gen() % live.size();
+                (void)book.amend_order(live[k], px,
+                                       static_cast<uint64_t>(quantity_dist(gen)));
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        auto micros = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        std::cout << std::fixed << std::setprecision(0);
+        std::cout << "  • Events: " << num_events << " in " << micros << " µs\n";
+        std::cout << "  • Throughput: " << (num_events * 1000000.0) / micros << " events/sec\n";
+        std::cout << "  • Active orders at end: " << book.get_stats().active_orders << "\n";
+    }
+
+    // Delta publisher consistency: a receiver reconstructing the band from
+    // incremental updates must end up byte-identical to get_snapshot
+    static void run_delta_publisher_test() {
+        std::cout << "\n╔════════════════════════════════╗\n";
+        std::cout << "║     DELTA PUBLISHER TEST        ║\n";
+        std::cout << "╚════════════════════════════════╝\n";
+
+        DeltaPublisher publisher;
+        OrderBook book;
+        book.set_delta_publisher(&publisher);
+
+        // Receiver state: the subscribed band rebuilt purely from deltas
+        std::map<Price, uint64_t, std::greater<Price>> recv_bids;
+        std::map<Price, uint64_t, std::less<Price>> recv_asks;
+        auto apply = [&](const LevelDelta& d) {
+            if (d.op == LevelDelta::Set) {
+                (d.is_bid ? recv_bids[d.price] : recv_asks[d.price]) = d.new_quantity;
+            } else {
+                if (d.is_bid) recv_bids.erase(d.price);
+                else          recv_asks.erase(d.price);
+            }
+        };
+
+        std::mt19937 gen(17);
+        std::uniform_real_distribution<> px(99.0, 101.0);
+        std::uniform_int_distribution<> qd(1, 500);
+        std::uniform_int_distribution<> action(0, 99);
+        std::vector<uint64_t> live;
+        uint64_t id = 1, deltas_applied = 0;
+        LevelDelta d;
+
+        for (int i = 0; i < 100000; ++i) {
+            int a = action(gen);
+            if (a < 55 || live.empty()) {
+                book.add_order({id, (gen() % 2) == 0, px(gen),
+                                static_cast<uint64_t>(qd(gen)), get_timestamp()});
+                live.push_back(id++);
+            } else if (a < 85) {
+                size_t k = gen() % live.size();
+                if (book.cancel_order(live[k])) {
+                    live[k] = live.back();
+                    live.pop_back();
+                }
+            } else {
+                size_t k = gen() % live.size();
+                (void)book.amend_order(live[k], px(gen),
+                                       static_cast<uint64_t>(qd(gen)));
+            }
+            // Drain inline: the SPSC ring must never back up into drops
+            while (publisher.poll(d)) {
+                apply(d);
+                ++deltas_applied;
+            }
+        }
+        book.set_delta_publisher(nullptr);
+
+        std::vector<PriceLevel> bids, asks;
+        book.get_snapshot(10, bids, asks);
+        bool ok = publisher.dropped() == 0
+                  && recv_bids.size() >= bids.size() && recv_asks.size() >= asks.size();
+        auto bit = recv_bids.begin();
+        for (size_t i = 0; ok && i < bids.size(); ++i, ++bit) {
+            ok = bit->first == bids[i].price && bit->second == bids[i].total_quantity;
+        }
+        auto ait = recv_asks.begin();
+        for (size_t i = 0; ok && i < asks.size(); ++i, ++ait) {
+            ok = ait->first == asks[i].price && ait->second == asks[i].total_quantity;
+        }
+
+        std::cout << "  • Deltas applied: " << deltas_applied
+                  << " (dropped " << publisher.dropped() << ")\n";
+        std::cout << (ok ? "  ✓ Receiver band matches get_snapshot\n"
+                         : "  ✗ Receiver band MISMATCH\n");
+    }
+
+    // Compile-time listener: hook counts must agree with the book's own
+    // counters, and a book with the NullListener must stay the same size
+    struct CountingListener {
+        uint64_t adds = 0, cancels = 0, amends = 0, trades = 0;
+        uint64_t traded_qty = 0;
+        inline void on_add(const Order&) { ++adds; }
+        inline void on_cancel(const Order&) { ++cancels; }
+        inline void on_amend(const Order&) { ++amends; }
+        inline void on_trade(const Trade& t) { ++trades; traded_qty += t.quantity; }
+    };
+
+    static void run_listener_test() {
+        std::cout << "\n╔════════════════════════════════╗\n";
+        std::cout << "║       LISTENER HOOK TEST        ║\n";
+        std::cout << "╚════════════════════════════════╝\n";
+
+        BasicOrderBook<StatsEnabled, CountingListener> book;
+
+        for (uint64_t id = 1; id <= 200; ++id) {
+            bool buy = (id % 2) == 0;
+            double px = buy ? 100.00 - (id % 10) * 0.01 : 100.05 + (id % 10) * 0.01;
+            book.add_order({id, buy, px, 100 + id, get_timestamp()});
+        }
+        for (uint64_t id = 1; id <= 50; ++id) {
+            (void)book.cancel_order(id);
+        }
+        for (uint64_t id = 51; id <= 90; ++id) {
+            (void)book.amend_order(id, 100.00 + (id % 5) * 0.01, 500);
+        }
+        Trade trades[16];
+        size_t n = book.submit_order({9001, true, 100.10, 400, get_timestamp()},
+                                     trades, 16);
+
+        auto stats = book.get_stats();
+        const auto& l = book.listener();
+        // submit_order's resting residual (if any) also fires on_add
+        bool ok = l.adds == stats.total_orders
+               && l.cancels == stats.total_cancels
+               && l.amends == stats.total_amends
+               && l.trades == n;
+
+        std::cout << "  • Hooks: " << l.adds << " adds, " << l.cancels
+                  << " cancels, " << l.amends << " amends, " << l.trades
+                  << " trades (" << l.traded_qty << " qty)\n";
+        std::cout << (ok ? "  ✓ Hook counts match book counters\n"
+                         : "  ✗ Hook counts DIVERGE from book counters\n");
+    }
+
+    // PoolPtr: unique handles must survive ring transit (movable, never
+    // copied) and every slot must come back to the pool, including objects
+    // still in the ring when it is destroyed
+    static void run_pool_ptr_test() {
+        std::cout << "\n╔════════════════════════════════╗\n";
+        std::cout << "║        POOL HANDLE TEST         ║\n";
+        std::cout << "╚════════════════════════════════╝\n";
+
+        using Pool = MemoryPool<OrderNode, 256, StatsEnabled>;
+        Pool pool;
+        uint64_t sum = 0;
+        {
+            Fifo4<PoolPtr<Pool>> ring(8);
+            for (uint64_t id = 1; id <= 6; ++id) {
+                ring.push(pool.acquire(Order{id, true, 100.0, 10, 0}, Price{10000}));
+            }
+            PoolPtr<Pool> handle;
+            for (int i = 0; i < 4; ++i) {
+                if (ring.pop(handle)) {
+                    sum += handle->order.order_id;
+                }
+            }
+            // Two handles stay in the ring; its destructor must return them
+        }
+        bool ok = sum == 1 + 2 + 3 + 4 && pool.free_objects() == 6;
+
+        std::cout << "  • 6 acquired, 4 popped (id sum " << sum
+                  << "), free slots after teardown: " << pool.free_objects() << "\n";
+        std::cout << (ok ? "  ✓ Every pooled object returned via its handle\n"
+                         : "  ✗ Pool slot LEAKED through the ring\n");
+    }
+
     // Stress test with edge cases
     static void run_stress_test() {
         std::cout << "\n╔════════════════════════════════╗\n";
@@ -792,7 +2437,7 @@ public:
         for (size_t i = 0; i < 5; ++i) {
             if (i < bids.size()) {
                 std::cout << "│ " << std::fixed << std::setprecision(2) 
-                          << std::setw(5) << bids[i].price << " x"
+                          << std::setw(5) << book.to_double(bids[i].price) << " x"
                           << std::setw(4) << bids[i].total_quantity << " │";
             } else {
                 std::cout << "│             │";
@@ -800,7 +2445,7 @@ public:
             
             if (i < asks.size()) {
                 std::cout << " " << std::fixed << std::setprecision(2)
-                          << std::setw(5) << asks[i].price << " x"
+                          << std::setw(5) << book.to_double(asks[i].price) << " x"
                           << std::setw(4) << asks[i].total_quantity << " │\n";
             } else {
                 std::cout << "              │\n";
@@ -829,8 +2474,13 @@ int main() {
     // Run all tests
     OrderBookExample::run_example();
     OrderBookTester::run_basic_test();
+    OrderBookTester::run_matching_test();
+    OrderBookTester::run_delta_publisher_test();
+    OrderBookTester::run_listener_test();
+    OrderBookTester::run_pool_ptr_test();
     OrderBookTester::run_stress_test();
     OrderBookTester::run_performance_test();
+    OrderBookTester::run_hot_path_benchmark();
     
     std::cout << "\n✅ All tests completed successfully!\n\n";
     
@@ -0,0 +1,54 @@
+#!/usr/bin/env bash
+# pgo_bench.sh - profile-guided optimization pipeline for the order book
+# Usage: ./pgo_bench.sh [events]   (default 1000000)
+#
+# The book's hot paths are exactly the shape PGO rewards: heavily biased
+# branches (found-vs-missing lookups, populated-vs-new levels) and
+# hot/cold splits (add_to_side vs print_detailed_stats) that static
+# heuristics cannot see. But profile feedback is only as good as the
+# training input, so this pipeline trains on the journal replay — real
+# captured flow through the real code paths — rather than a synthetic
+# loop. Three stages: baseline build, instrumented build + training run
+# (-fprofile-generate), optimized build consuming the profile
+# (-fprofile-use), then both binaries replay the same journal and the
+# throughput delta is reported. Expect ~10-15% on the branchy
+# map-and-hash code; re-train whenever flow characteristics change.
+
+set -euo pipefail
+cd "$(dirname "$0")"
+
+EVENTS="${1:-1000000}"
+CXX="${CXX:-g++}"
+WORK="${TMPDIR:-/tmp}/pgo_bench"
+FLAGS="-std=c++17 -O3 -march=native -flto -DNDEBUG -w -pthread -DJOURNAL_MAIN"
+
+mkdir -p "$WORK"
+rm -f "$WORK"/*.gcda
+
+echo "── stage 1: baseline build"
+$CXX $FLAGS journal.cpp -o "$WORK/replay_base"
+
+echo "── stage 2: instrumented build + training replay ($EVENTS events)"
+$CXX $FLAGS -fprofile-generate="$WORK/profile" journal.cpp -o "$WORK/replay_train"
+"$WORK/replay_train" "$WORK/train.journal" "$EVENTS" > /dev/null
+
+echo "── stage 3: optimized build from profile"
+$CXX $FLAGS -fprofile-use="$WORK/profile" -fprofile-correction \
+     journal.cpp -o "$WORK/replay_pgo"
+
+# Measurement: both binaries capture and replay the same flow (fixed seed);
+# take the mmap-replay throughput, the closest proxy for live processing
+measure() {
+    "$1" "$WORK/bench.journal" "$EVENTS" \
+        | awk '/Throughput/ { v = $3 } END { print v }'
+}
+
+echo "── measuring"
+base=$(measure "$WORK/replay_base")
+pgo=$(measure "$WORK/replay_pgo")
+
+awk -v base="$base" -v pgo="$pgo" 'BEGIN {
+    printf "  baseline: %12.0f events/sec\n", base
+    printf "  PGO:      %12.0f events/sec\n", pgo
+    printf "  delta:    %+.1f%%\n", (pgo - base) * 100.0 / base
+}'
@@ -0,0 +1,269 @@
+// sharded_engine.cpp - symbol-sharded parallel engine over pinned workers
+// Compile: g++ -std=c++17 -O3 -march=native -DSHARDED_ENGINE_MAIN sharded_engine.cpp -o sharded_engine -pthread
+//
+// One thread over 2,000 symbols caps the whole system at single-core
+// throughput, and symbols never share state — they are embarrassingly
+// parallel. The engine partitions symbols across N worker threads, each
+// pinned to its own core and owning a private OrderBookManager (books AND
+// pools: no allocation traffic ever crosses a shard boundary). A dispatcher
+// routes each message by symbol id through a per-worker SPSC Fifo3, so the
+// only cross-thread structure is the queue itself. Partition choice is an
+// explicit table, not a fixed hash, because real flow is skewed: the load
+// report shows per-shard and per-symbol message counts so hot symbols can
+// be spread across shards at config time.
+
+#pragma once
+#include <pthread.h>
+#include <thread>
+
+#include "book_manager.cpp"
+#include "../SPSC_QUEUES/spsc_q3.cpp"
+
+// ======================== SHARD MESSAGE ========================
+
+// Envelope routed by the dispatcher; one per feed event
+struct ShardMessage {
+    uint32_t symbol;
+    BookUpdate::Op op;
+    Order order;             // Fully populated for Add; id/price/qty for Amend
+};
+
+// ======================== SHARDED ENGINE ========================
+
+// Same helper as feed_pipeline.cpp: pin the calling thread to one core
+inline bool shard_pin_to_core(int core) {
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(core, &cpuset);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset) == 0;
+}
+
+template<typename StatsPolicy = DefaultStats>
+class ShardedEngine {
+public:
+    using Manager = BasicOrderBookManager<StatsPolicy>;
+    using SymbolId = typename Manager::SymbolId;
+
+    ShardedEngine(size_t num_shards, size_t max_symbols,
+                  size_t queue_capacity = 4096)
+        : num_shards_(num_shards) {
+        shards_.reserve(num_shards);
+        for (size_t s = 0; s < num_shards; ++s) {
+            shards_.push_back(std::make_unique<Shard>(max_symbols, queue_capacity));
+        }
+        shard_of_symbol_.reserve(max_symbols);
+        local_id_.reserve(max_symbols);
+    }
+
+    // Register a symbol on a shard (round-robin by default; pass an explicit
+    // shard to place a known-hot symbol). Startup only, never concurrent
+    // with start().
+    SymbolId add_symbol(const std::string& name, double tick_size = 0.01,
+                        size_t shard = SIZE_MAX) {
+        if (shard == SIZE_MAX) {
+            shard = shard_of_symbol_.size() % num_shards_;
+        }
+        SymbolId global = static_cast<SymbolId>(shard_of_symbol_.size());
+        shard_of_symbol_.push_back(static_cast<uint32_t>(shard));
+        local_id_.push_back(shards_[shard]->manager.add_symbol(name, tick_size));
+        return global;
+    }
+
+    // Start one pinned worker per shard
+    void start() {
+        running_.store(true, std::memory_order_release);
+        for (size_t s = 0; s < num_shards_; ++s) {
+            shards_[s]->worker = std::thread([this, s] { run_shard(s); });
+        }
+    }
+
+    // Drain every queue, then join the workers
+    void stop() {
+        running_.store(false, std::memory_order_release);
+        for (auto& shard : shards_) {
+            if (shard->worker.joinable()) shard->worker.join();
+        }
+    }
+
+    // Dispatcher entry: route on symbol id, spin if the shard is behind.
+    // Single dispatcher thread by design — the queues are SPSC.
+    void dispatch(SymbolId symbol, BookUpdate::Op op, const Order& order) {
+        Shard& shard = *shards_[shard_of_symbol_[symbol]];
+        while (!shard.queue.emplace(ShardMessage{local_id_[symbol], op, order})) {
+            // Shard behind: backpressure lands here, visible in the report
+            ++shard.dispatch_stalls;
+        }
+    }
+
+    // Post-stop inspection: the book for a global symbol id
+    [[nodiscard]] typename Manager::Book& book(SymbolId symbol) {
+        return shards_[shard_of_symbol_[symbol]]->manager.book(local_id_[symbol]);
+    }
+
+    [[nodiscard]] uint64_t processed(size_t shard) const {
+        return shards_[shard]->processed;
+    }
+
+    // Per-shard load so partitions can be tuned around hot symbols: a shard
+    // 2x over the mean is the one to split
+    void print_load_report() const {
+        uint64_t total = 0;
+        for (const auto& shard : shards_) total += shard->processed;
+        double mean = num_shards_ ? static_cast<double>(total) / num_shards_ : 0.0;
+
+        std::cout << "\n┌─── SHARD LOAD REPORT ──────────────────────────┐\n";
+        for (size_t s = 0; s < num_shards_; ++s) {
+            const Shard& shard = *shards_[s];
+            double rel = mean > 0 ? shard.processed / mean : 0.0;
+            std::cout << "│ shard " << s << " (core " << s << "): "
+                      << std::setw(9) << shard.processed << " msgs  "
+                      << std::fixed << std::setprecision(2) << rel << "x mean"
+                      << (rel > 1.5 ? "  <- split this partition" : "")
+                      << "\n";
+            // The shard's busiest symbols, the candidates to move
+            const auto& counts = shard.symbol_msgs;
+            std::vector<size_t> idx(counts.size());
+            for (size_t i = 0; i < idx.size(); ++i) idx[i] = i;
+            std::sort(idx.begin(), idx.end(), [&](size_t a, size_t b) {
+                return counts[a] > counts[b];
+            });
+            for (size_t i = 0; i < idx.size() && i < 3; ++i) {
+                if (counts[idx[i]] == 0) break;
+                std::cout << "│     " << std::setw(10) << std::left
+                          << shard.manager.symbol_name(
+                                 static_cast<SymbolId>(idx[i]))
+                          << std::right << std::setw(9) << counts[idx[i]]
+                          << " msgs\n";
+            }
+            if (shard.dispatch_stalls) {
+                std::cout << "│     dispatcher stalled " << shard.dispatch_stalls
+                          << " times pushing to this shard\n";
+            }
+        }
+        std::cout << "└────────────────────────────────────────────────┘\n";
+    }
+
+private:
+    struct Shard {
+        Shard(size_t max_symbols, size_t queue_capacity)
+            : manager(max_symbols), queue(queue_capacity),
+              symbol_msgs(max_symbols, 0) {}
+
+        Manager manager;                  // books + private pools
+        Fifo3<ShardMessage> queue;        // dispatcher -> this worker
+        std::thread worker;
+        uint64_t processed = 0;           // written by the worker only
+        uint64_t dispatch_stalls = 0;     // written by the dispatcher only
+        std::vector<uint64_t> symbol_msgs; // per-symbol load, worker-owned
+    };
+
+    void run_shard(size_t s) {
+        Shard& shard = *shards_[s];
+        if (!shard_pin_to_core(static_cast<int>(s))) {
+            std::cout << "⚠️  Could not pin shard " << s << " to core " << s << "\n";
+        }
+
+        ShardMessage msg;
+        for (;;) {
+            if (!shard.queue.pop(msg)) {
+                // Empty queue: exit only once the dispatcher has stopped
+                if (!running_.load(std::memory_order_acquire) &&
+                    shard.queue.empty()) {
+                    return;
+                }
+                continue;
+            }
+            switch (msg.op) {
+                case BookUpdate::Op::Add:
+                    shard.manager.add_order(msg.symbol, msg.order);
+                    break;
+                case BookUpdate::Op::Cancel:
+                    (void)shard.manager.cancel_order(msg.symbol, msg.order.order_id);
+                    break;
+                case BookUpdate::Op::Amend:
+                    (void)shard.manager.amend_order(msg.symbol, msg.order.order_id,
+                                                    msg.order.price,
+                                                    msg.order.quantity);
+                    break;
+            }
+            ++shard.processed;
+            ++shard.symbol_msgs[msg.symbol];
+        }
+    }
+
+    size_t num_shards_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::vector<uint32_t> shard_of_symbol_;   // global symbol -> shard
+    std::vector<SymbolId> local_id_;          // global symbol -> id within shard
+    std::atomic<bool> running_{false};
+};
+
+// ======================== MAIN FUNCTION ========================
+
+#ifdef SHARDED_ENGINE_MAIN
+int main(int argc, char** argv) {
+    const int num_messages = argc > 1 ? std::atoi(argv[1]) : 400000;
+    const size_t num_shards = argc > 2 ? static_cast<size_t>(std::atoi(argv[2])) : 2;
+    const size_t num_symbols = 64;
+
+    ShardedEngine<> engine(num_shards, num_symbols);
+    for (size_t i = 0; i < num_symbols; ++i) {
+        engine.add_symbol("SYM" + std::to_string(i), 0.01);
+    }
+
+    // Skewed flow: a few symbols carry most of the volume, like real tape
+    std::mt19937 gen(99);
+    std::uniform_real_distribution<> price_dist(90.0, 110.0);
+    std::uniform_int_distribution<> quantity_dist(100, 1000);
+    std::uniform_int_distribution<> action_dist(0, 9);
+    std::uniform_int_distribution<uint32_t> hot_dist(0, 3);
+    std::uniform_int_distribution<uint32_t> cold_dist(4, num_symbols - 1);
+    std::uniform_int_distribution<> skew_dist(0, 99);
+
+    engine.start();
+    auto t0 = std::chrono::high_resolution_clock::now();
+
+    std::vector<uint64_t> next_id(num_symbols, 1);
+    uint64_t adds = 0;
+    for (int i = 0; i < num_messages; ++i) {
+        uint32_t sym = skew_dist(gen) < 70 ? hot_dist(gen) : cold_dist(gen);
+        int action = action_dist(gen);
+        if (action < 8 || next_id[sym] < 100) {
+            Order order{next_id[sym]++, (gen() % 2) == 0, price_dist(gen),
+                        static_cast<uint64_t>(quantity_dist(gen)), 0};
+            engine.dispatch(sym, BookUpdate::Op::Add, order);
+            ++adds;
+        } else {
+            uint64_t victim = 1 + gen() % (next_id[sym] - 1);
+            Order ref{victim, true, price_dist(gen),
+                      static_cast<uint64_t>(quantity_dist(gen)), 0};
+            engine.dispatch(sym, action == 8 ? BookUpdate::Op::Cancel
+                                             : BookUpdate::Op::Amend, ref);
+        }
+    }
+
+    engine.stop();
+    auto t1 = std::chrono::high_resolution_clock::now();
+    double secs = std::chrono::duration<double>(t1 - t0).count();
+
+    uint64_t processed = 0;
+    for (size_t s = 0; s < num_shards; ++s) processed += engine.processed(s);
+
+    uint64_t resting = 0;
+    for (uint32_t sym = 0; sym < num_symbols; ++sym) {
+        resting += engine.book(sym).get_stats().active_orders;
+    }
+
+    std::cout << "dispatched " << num_messages << " msgs to " << num_shards
+              << " shards in " << std::fixed << std::setprecision(2) << secs
+              << " s (" << static_cast<uint64_t>(num_messages / secs)
+              << " msgs/sec)\n";
+    std::cout << "processed " << processed << ", resting orders across books: "
+              << resting << "\n";
+    engine.print_load_report();
+
+    bool ok = processed == static_cast<uint64_t>(num_messages) && resting <= adds;
+    std::cout << (ok ? "\nALL MESSAGES ROUTED AND APPLIED\n" : "\nMESSAGE LOSS\n");
+    return ok ? 0 : 1;
+}
+#endif
@@ -0,0 +1,293 @@
+// telemetry.hpp - shared-memory export of live book counters
+// Compile: g++ -std=c++17 -O3 -march=native -DTELEMETRY_MAIN telemetry.cpp -o telemetry -pthread
+// Sidecar: ./telemetry --watch [segment-name]
+//
+// print_detailed_stats drives std::cout with iomanip formatting — fine in a
+// tester, unusable next to the feed. This moves observability out of the
+// trading process entirely: the book's counters, queue depth and the raw
+// latency histogram buckets go into a fixed-layout shared-memory segment
+// under a seqlock (the book_mirror.cpp pattern), and a sidecar process maps
+// the same segment read-only and pays every formatting and percentile cost
+// itself. After setup, publish() is plain stores into mapped memory — zero
+// syscalls, zero formatting, nothing for the kernel to do on the hot path.
+
+#pragma once
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "orderbook.cpp"
+
+// ======================== SEGMENT LAYOUT ========================
+
+// Raw histogram image: bucket counts only; the sidecar rebuilds a
+// LatencyHistogram from these and computes percentiles on its own time
+struct HistogramImage {
+    uint64_t buckets[LatencyHistogram::MAJORS][LatencyHistogram::SUBS];
+    uint64_t count;
+    uint64_t max_ns;
+};
+static_assert(sizeof(HistogramImage) == 32 * 32 * 8 + 16,
+              "histogram image layout changed");
+
+struct TelemetryFrame {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t reserved;
+    std::atomic<uint64_t> seq;   // seqlock: odd while the writer is mid-update
+
+    // OrderBook::Stats counters
+    uint64_t total_orders;
+    uint64_t total_cancels;
+    uint64_t total_amends;
+    uint64_t active_orders;
+    uint64_t bid_levels;
+    uint64_t ask_levels;
+    double best_bid;
+    double best_ask;
+    double spread;
+
+    // Pipeline health
+    uint64_t queue_depth;        // e.g. Fifo3::size() at publish time
+    uint64_t publish_count;
+
+    HistogramImage add_latency;
+    HistogramImage cancel_latency;
+    HistogramImage amend_latency;
+    HistogramImage snapshot_latency;
+
+    static constexpr uint64_t MAGIC = 0x314D4C545F424FULL;  // "OB_TLM1"
+    static constexpr uint32_t VERSION = 1;
+};
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+static_assert(offsetof(TelemetryFrame, seq) == 16, "frame layout drift");
+static_assert(offsetof(TelemetryFrame, total_orders) == 24, "frame layout drift");
+static_assert(std::is_trivially_destructible_v<TelemetryFrame>);
+
+// ======================== EXPORTER (TRADING PROCESS) ========================
+
+class TelemetryExporter {
+public:
+    static constexpr const char* DEFAULT_NAME = "/orderbook_telemetry";
+
+    // All syscalls happen here, once, before go-live
+    explicit TelemetryExporter(const std::string& name = DEFAULT_NAME) {
+        int fd = ::shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+        if (fd < 0 || ::ftruncate(fd, sizeof(TelemetryFrame)) != 0) {
+            if (fd >= 0) ::close(fd);
+            throw std::runtime_error("TelemetryExporter: cannot create segment " + name);
+        }
+        void* addr = ::mmap(nullptr, sizeof(TelemetryFrame),
+                            PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) {
+            throw std::runtime_error("TelemetryExporter: mmap failed on " + name);
+        }
+        frame_ = static_cast<TelemetryFrame*>(addr);
+        std::memset(static_cast<void*>(frame_), 0, sizeof(TelemetryFrame));
+        frame_->magic = TelemetryFrame::MAGIC;
+        frame_->version = TelemetryFrame::VERSION;
+        frame_->seq.store(0, std::memory_order_release);
+    }
+
+    ~TelemetryExporter() {
+        if (frame_) ::munmap(frame_, sizeof(TelemetryFrame));
+    }
+
+    TelemetryExporter(const TelemetryExporter&) = delete;
+    TelemetryExporter& operator=(const TelemetryExporter&) = delete;
+
+    // Snapshot the book's counters into the segment: plain stores bracketed
+    // by the seqlock. Call off the critical path (end of a drain batch, or a
+    // timer tick) — cost is the counter copies, nothing else.
+    template<typename Book>
+    void publish(const Book& book, uint64_t queue_depth = 0) {
+        auto stats = book.get_stats();
+        auto histos = book.latency_histograms();
+
+        uint64_t seq = frame_->seq.load(std::memory_order_relaxed);
+        frame_->seq.store(seq + 1, std::memory_order_release);  // odd: in progress
+        std::atomic_thread_fence(std::memory_order_release);
+
+        frame_->total_orders = stats.total_orders;
+        frame_->total_cancels = stats.total_cancels;
+        frame_->total_amends = stats.total_amends;
+        frame_->active_orders = stats.active_orders;
+        frame_->bid_levels = stats.bid_levels;
+        frame_->ask_levels = stats.ask_levels;
+        frame_->best_bid = stats.best_bid;
+        frame_->best_ask = stats.best_ask;
+        frame_->spread = stats.spread;
+        frame_->queue_depth = queue_depth;
+        frame_->publish_count = publishes_ + 1;
+
+        copy_histogram(frame_->add_latency, histos.add);
+        copy_histogram(frame_->cancel_latency, histos.cancel);
+        copy_histogram(frame_->amend_latency, histos.amend);
+        copy_histogram(frame_->snapshot_latency, histos.snapshot);
+
+        std::atomic_thread_fence(std::memory_order_release);
+        frame_->seq.store(seq + 2, std::memory_order_release); // even: stable
+        ++publishes_;
+    }
+
+private:
+    static void copy_histogram(HistogramImage& dst, const LatencyHistogram* src) {
+        if (!src) return;   // stats compiled out: leave the image zeroed
+        std::memcpy(dst.buckets, src->buckets, sizeof(dst.buckets));
+        dst.count = src->count;
+        dst.max_ns = src->max_ns;
+    }
+
+    TelemetryFrame* frame_ = nullptr;
+    uint64_t publishes_ = 0;
+};
+
+// ======================== SIDECAR READER ========================
+
+class TelemetryReader {
+public:
+    explicit TelemetryReader(const std::string& name = TelemetryExporter::DEFAULT_NAME) {
+        int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            throw std::runtime_error("TelemetryReader: cannot open segment " + name);
+        }
+        void* addr = ::mmap(nullptr, sizeof(TelemetryFrame), PROT_READ,
+                            MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) {
+            throw std::runtime_error("TelemetryReader: mmap failed on " + name);
+        }
+        frame_ = static_cast<const TelemetryFrame*>(addr);
+        if (frame_->magic != TelemetryFrame::MAGIC ||
+            frame_->version != TelemetryFrame::VERSION) {
+            throw std::runtime_error("TelemetryReader: bad segment " + name);
+        }
+    }
+
+    ~TelemetryReader() {
+        if (frame_) ::munmap(const_cast<TelemetryFrame*>(frame_),
+                             sizeof(TelemetryFrame));
+    }
+
+    TelemetryReader(const TelemetryReader&) = delete;
+    TelemetryReader& operator=(const TelemetryReader&) = delete;
+
+    // Copy out a consistent frame; retries while the writer is mid-update.
+    // Returns the sequence number of the frame read.
+    uint64_t read(TelemetryFrame& out) const {
+        for (;;) {
+            uint64_t before = frame_->seq.load(std::memory_order_acquire);
+            if (before & 1) continue;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            std::memcpy(static_cast<void*>(&out),
+                        static_cast<const void*>(frame_), sizeof(TelemetryFrame));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint64_t after = frame_->seq.load(std::memory_order_acquire);
+            if (before == after) return before;
+        }
+    }
+
+    // All the iomanip the trading process no longer pays
+    static void print(const TelemetryFrame& f) {
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "publish #" << f.publish_count
+                  << "  orders " << f.total_orders
+                  << " (active " << f.active_orders << ")"
+                  << "  cancels " << f.total_cancels
+                  << "  amends " << f.total_amends
+                  << "  levels " << f.bid_levels << "x" << f.ask_levels
+                  << "  bbo " << f.best_bid << "/" << f.best_ask
+                  << "  queue " << f.queue_depth << "\n";
+        LatencyHistogram::print_header();
+        rebuild(f.add_latency).print("add");
+        rebuild(f.cancel_latency).print("cancel");
+        rebuild(f.amend_latency).print("amend");
+        rebuild(f.snapshot_latency).print("get_snapshot");
+    }
+
+private:
+    // Percentiles are computed sidecar-side from the raw buckets
+    static LatencyHistogram rebuild(const HistogramImage& img) {
+        LatencyHistogram h;
+        std::memcpy(h.buckets, img.buckets, sizeof(h.buckets));
+        h.count = img.count;
+        h.max_ns = img.max_ns;
+        return h;
+    }
+
+    const TelemetryFrame* frame_ = nullptr;
+};
+
+// ======================== MAIN FUNCTION ========================
+
+#ifdef TELEMETRY_MAIN
+#include <thread>
+
+// Sidecar mode: scrape an existing segment once a second until killed
+static int run_sidecar(const std::string& name) {
+    TelemetryReader reader(name);
+    TelemetryFrame frame;
+    for (;;) {
+        reader.read(frame);
+        TelemetryReader::print(frame);
+        ::usleep(1000000);
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "--watch") {
+        return run_sidecar(argc > 2 ? argv[2] : TelemetryExporter::DEFAULT_NAME);
+    }
+
+    // Self-test: trading thread publishes while a reader maps the same
+    // segment (as the sidecar would) and checks frame consistency
+    const std::string name = "/orderbook_telemetry_test";
+    TelemetryExporter exporter(name);
+
+    BasicOrderBook<StatsEnabled> book;
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<> price_dist(95.0, 105.0);
+    std::uniform_int_distribution<> quantity_dist(100, 1000);
+
+    const int num_events = 200000;
+    const int publish_every = 1024;
+    for (int i = 1; i <= num_events; ++i) {
+        book.add_order({static_cast<uint64_t>(i), (i % 2) == 0, price_dist(gen),
+                        static_cast<uint64_t>(quantity_dist(gen)), 0});
+        if (i > 1000 && (i % 3) == 0) {
+            (void)book.cancel_order(static_cast<uint64_t>(i - 1000));
+        }
+        if ((i % publish_every) == 0) {
+            exporter.publish(book, static_cast<uint64_t>(i % 100));
+        }
+    }
+    exporter.publish(book);
+
+    TelemetryReader reader(name);
+    TelemetryFrame frame;
+    uint64_t seq = reader.read(frame);
+
+    auto stats = book.get_stats();
+    bool ok = (seq % 2) == 0
+           && frame.total_orders == stats.total_orders
+           && frame.total_cancels == stats.total_cancels
+           && frame.active_orders == stats.active_orders
+           && frame.add_latency.count == stats.total_orders
+           && frame.cancel_latency.count == stats.total_cancels;
+
+    std::cout << "scraped frame (seq " << seq << "):\n";
+    TelemetryReader::print(frame);
+    std::cout << (ok ? "\nTELEMETRY FRAME CONSISTENT with book\n"
+                     : "\nTELEMETRY MISMATCH\n");
+
+    ::shm_unlink(name.c_str());
+    return ok ? 0 : 1;
+}
+#endif
@@ -0,0 +1,256 @@
+// timing.hpp - calibrated rdtsc clock, scoped spans, off-thread collection
+// Compile: g++ -std=c++17 -O3 -march=native -DTIMING_MAIN timing.cpp -o timing -pthread
+//
+// chrono's clocks cost 20-30ns per call — cheap enough to sample, too slow
+// to timestamp every message, which is why today's numbers are means with no
+// tail. TscClock reads the TSC (a few cycles, constant-rate on every box we
+// deploy on) and converts to nanoseconds with a once-per-process calibration
+// against steady_clock. ScopedSpan stamps entry/exit and pushes a fixed-size
+// record into an SPSC ring; a background thread drains the ring and
+// aggregates per-tag log2 histograms, so the hot path pays two TSC reads and
+// one ring push per span and attribution happens entirely off-thread.
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include "../SPSC_QUEUES/spsc_q4.cpp"
+
+// ======================== TSC CLOCK ========================
+
+class TscClock {
+public:
+    // Raw cycle counter: the cheapest timestamp the hardware offers
+    static inline uint64_t cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __builtin_ia32_rdtsc();
+#else
+        return static_cast<uint64_t>(
+            std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    // Nanoseconds per cycle, measured once against steady_clock. ~10ms of
+    // calibration keeps the error well under the jitter we are measuring.
+    static double ns_per_cycle() {
+        static const double ratio = calibrate();
+        return ratio;
+    }
+
+    // Monotonic nanoseconds since an arbitrary origin; only differences are
+    // meaningful (exactly like steady_clock)
+    static inline uint64_t now_ns() {
+        return static_cast<uint64_t>(cycles() * ns_per_cycle());
+    }
+
+    static inline uint64_t cycles_to_ns(uint64_t c) {
+        return static_cast<uint64_t>(c * ns_per_cycle());
+    }
+
+private:
+    static double calibrate() {
+#if defined(__x86_64__) || defined(__i386__)
+        auto wall_start = std::chrono::steady_clock::now();
+        uint64_t tsc_start = cycles();
+        // Busy-wait: sleeping would let the calibration window get descheduled
+        for (;;) {
+            auto wall_now = std::chrono::steady_clock::now();
+            if (wall_now - wall_start >= std::chrono::milliseconds(10)) {
+                uint64_t tsc_now = cycles();
+                auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              wall_now - wall_start).count();
+                return static_cast<double>(ns) / static_cast<double>(tsc_now - tsc_start);
+            }
+        }
+#else
+        return 1.0;  // fallback path already returns nanoseconds
+#endif
+    }
+};
+
+// ======================== SPAN RECORDS ========================
+
+// One measured interval; tags are small integers the collector maps to names
+struct SpanRecord {
+    uint32_t tag;
+    uint32_t reserved;
+    uint64_t start_cycles;
+    uint64_t end_cycles;
+};
+
+// ======================== COLLECTOR ========================
+
+// Drains span records off the hot path and aggregates per-tag log2-bucket
+// histograms (same bucketing as LatencyHistogram in orderbook.cpp). The
+// producing thread pays one Fifo4 push; records are dropped (and counted)
+// rather than ever blocking the producer.
+class SpanCollector {
+public:
+    static constexpr size_t MAX_TAGS = 16;
+    static constexpr size_t BUCKETS = 32;
+
+    explicit SpanCollector(size_t ring_capacity = 1 << 16)
+        : ring_(ring_capacity), drain_thread_([this] { drain_loop(); }) {}
+
+    ~SpanCollector() {
+        stop();
+    }
+
+    void set_tag_name(uint32_t tag, const char* name) {
+        if (tag < MAX_TAGS) tag_names_[tag] = name;
+    }
+
+    // Hot-path entry: one push, never blocks
+    inline void record(uint32_t tag, uint64_t start_cycles, uint64_t end_cycles) {
+        if (!ring_.push(SpanRecord{tag, 0, start_cycles, end_cycles})) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Stop draining (idempotent); remaining records are flushed first
+    void stop() {
+        if (!stopped_.exchange(true)) {
+            drain_thread_.join();
+        }
+    }
+
+    void print(std::ostream& os = std::cout) {
+        os << "\n╔════════════════════════════════╗\n";
+        os << "║        SPAN LATENCIES           ║\n";
+        os << "╚════════════════════════════════╝\n";
+        for (uint32_t tag = 0; tag < MAX_TAGS; ++tag) {
+            const TagStats& s = stats_[tag];
+            if (s.count == 0) continue;
+            os << "  " << (tag_names_[tag] ? tag_names_[tag] : "tag?") << ": "
+               << s.count << " spans, mean "
+               << static_cast<uint64_t>(s.total_ns / s.count) << " ns, "
+               << "p50 " << percentile(s, 0.50) << " ns, "
+               << "p99 " << percentile(s, 0.99) << " ns, "
+               << "max " << s.max_ns << " ns\n";
+        }
+        uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+        if (dropped) {
+            os << "  (dropped " << dropped << " records: ring too small)\n";
+        }
+    }
+
+private:
+    struct TagStats {
+        uint64_t count = 0;
+        uint64_t total_ns = 0;
+        uint64_t max_ns = 0;
+        uint64_t buckets[BUCKETS] = {};
+    };
+
+    void drain_loop() {
+        SpanRecord batch[256];
+        while (true) {
+            size_t n = ring_.pop_n(batch, 256);
+            if (n == 0) {
+                if (stopped_.load(std::memory_order_acquire)) break;
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                continue;
+            }
+            for (size_t i = 0; i < n; ++i) {
+                aggregate(batch[i]);
+            }
+        }
+    }
+
+    void aggregate(const SpanRecord& rec) {
+        if (rec.tag >= MAX_TAGS) return;
+        uint64_t ns = TscClock::cycles_to_ns(rec.end_cycles - rec.start_cycles);
+        TagStats& s = stats_[rec.tag];
+        ++s.count;
+        s.total_ns += ns;
+        s.max_ns = std::max(s.max_ns, ns);
+        unsigned bucket = ns == 0 ? 0 : 64 - __builtin_clzll(ns);
+        s.buckets[std::min<unsigned>(bucket, BUCKETS - 1)]++;
+    }
+
+    // Bucket-resolution percentile: returns the upper bound of the bucket
+    // holding the requested rank
+    static uint64_t percentile(const TagStats& s, double p) {
+        uint64_t rank = static_cast<uint64_t>(s.count * p);
+        uint64_t seen = 0;
+        for (size_t b = 0; b < BUCKETS; ++b) {
+            seen += s.buckets[b];
+            if (seen > rank) return b == 0 ? 1 : (uint64_t{1} << b);
+        }
+        return s.max_ns;
+    }
+
+    Fifo4<SpanRecord> ring_;
+    std::atomic<bool> stopped_{false};
+    std::atomic<uint64_t> dropped_{0};
+    TagStats stats_[MAX_TAGS];           // touched only by the drain thread
+    const char* tag_names_[MAX_TAGS] = {};
+    std::thread drain_thread_;
+};
+
+// RAII span: stamps on entry, records on exit
+class ScopedSpan {
+public:
+    ScopedSpan(SpanCollector& collector, uint32_t tag)
+        : collector_(collector), tag_(tag), start_(TscClock::cycles()) {}
+    ~ScopedSpan() {
+        collector_.record(tag_, start_, TscClock::cycles());
+    }
+
+    ScopedSpan(const ScopedSpan&) = delete;
+    ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+private:
+    SpanCollector& collector_;
+    uint32_t tag_;
+    uint64_t start_;
+};
+
+// ======================== MAIN FUNCTION ========================
+
+#ifdef TIMING_MAIN
+int main() {
+    std::cout << "calibration: " << TscClock::ns_per_cycle() << " ns/cycle ("
+              << std::fixed << std::setprecision(2)
+              << 1.0 / TscClock::ns_per_cycle() << " GHz)\n";
+
+    // Clock cost comparison: the reason this module exists
+    constexpr int N = 1000000;
+    uint64_t sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < N; ++i) sink += TscClock::cycles();
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < N; ++i) {
+        sink += std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    auto ns = [](auto a, auto b) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(b - a).count();
+    };
+    std::cout << "per-call cost: rdtsc " << ns(t0, t1) / N
+              << " ns vs steady_clock " << ns(t1, t2) / N << " ns (sink "
+              << sink % 10 << ")\n";
+
+    // Span collection round trip
+    {
+        SpanCollector collector;
+        collector.set_tag_name(0, "fast_work");
+        collector.set_tag_name(1, "slow_work");
+        for (int i = 0; i < 100000; ++i) {
+            ScopedSpan span(collector, 0);
+        }
+        for (int i = 0; i < 1000; ++i) {
+            ScopedSpan span(collector, 1);
+            volatile int spin = 0;
+            for (int j = 0; j < 1000; ++j) spin += j;
+        }
+        collector.stop();
+        collector.print();
+    }
+    return 0;
+}
+#endif